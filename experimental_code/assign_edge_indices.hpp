@@ -0,0 +1,41 @@
+#ifndef ASSIGN_EDGE_INDICES_HPP
+#define ASSIGN_EDGE_INDICES_HPP
+
+#include <stddef.h>
+
+#include <vector>
+
+#include <boost/graph/graph_traits.hpp>
+#include <boost/graph/properties.hpp>
+
+
+// Numbers the edges of a graph with an interior boost::edge_index_t property from 0 in the order of boost::edges(),
+// so that edge sets and per-edge values can be kept in vectors indexed by edge index.
+template <typename Graph> void assign_edge_indices(Graph& graph) {
+    auto edge_index_map = boost::get(boost::edge_index, graph);
+
+    size_t edge_index = 0;
+
+    typename boost::graph_traits<Graph>::edge_iterator edge_iterator, edge_end;
+    for (std::tie(edge_iterator, edge_end) = boost::edges(graph); edge_iterator != edge_end; ++edge_iterator) {
+        boost::put(edge_index_map, *edge_iterator, edge_index++);
+    }
+}
+
+// the edges of a graph numbered by assign_edge_indices(), in ascending order of edge index
+template <typename Graph> std::vector<typename boost::graph_traits<Graph>::edge_descriptor> get_edges_in_ascending_order_of_edge_index(
+    const Graph& graph
+) {
+    const auto edge_index_map = boost::get(boost::edge_index, graph);
+
+    std::vector<typename boost::graph_traits<Graph>::edge_descriptor> edges(boost::num_edges(graph));
+
+    typename boost::graph_traits<Graph>::edge_iterator edge_iterator, edge_end;
+    for (std::tie(edge_iterator, edge_end) = boost::edges(graph); edge_iterator != edge_end; ++edge_iterator) {
+        edges[boost::get(edge_index_map, *edge_iterator)] = *edge_iterator;
+    }
+
+    return edges;
+}
+
+#endif
@@ -0,0 +1,49 @@
+#ifndef BARRIER_HPP
+#define BARRIER_HPP
+
+#include <stddef.h>
+
+#include <condition_variable>
+#include <mutex>
+
+
+// A reusable barrier for a fixed number of threads (as std::barrier, which needs C++20),
+// for tasks posted to a boost::asio::thread_pool that proceed in lockstep, e.g., level by level.
+// Each of the number_of_threads tasks must be running on its own thread, or arrive_and_wait() never returns.
+class Barrier {
+public:
+    explicit Barrier(const size_t number_of_threads) :
+        number_of_threads(number_of_threads),
+        number_of_waiting_threads(0),
+        generation(0)
+    {}
+
+    void arrive_and_wait() {
+        std::unique_lock<std::mutex> lock(mutex);
+        const size_t arrival_generation = generation;
+
+        if (++number_of_waiting_threads == number_of_threads) {
+            number_of_waiting_threads = 0;
+            ++generation;
+            lock.unlock();
+            condition_variable.notify_all();
+        }
+        else {
+            condition_variable.wait(
+                lock,
+                [this, arrival_generation]() {
+                    return generation != arrival_generation;
+                }
+            );
+        }
+    }
+
+private:
+    const size_t number_of_threads;
+    size_t number_of_waiting_threads;
+    size_t generation;
+    std::mutex mutex;
+    std::condition_variable condition_variable;
+};
+
+#endif
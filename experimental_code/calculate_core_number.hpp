@@ -9,28 +9,26 @@
 #include <vector>
 
 #include <boost/graph/graph_traits.hpp>
-#include <boost/unordered_map.hpp>
+#include <boost/graph/properties.hpp>
 
 
-template <typename Graph> boost::unordered_map<
-    typename boost::graph_traits<Graph>::vertex_descriptor,
+// returns the core number of each vertex in a vector indexed by vertex index (vertices not in graph, e.g., filtered out, get 0)
+template <typename Graph> std::vector<
     typename boost::graph_traits<Graph>::degree_size_type
 > calculate_core_number(
     const Graph& graph
 ) {
-    boost::unordered_map<
-        typename boost::graph_traits<Graph>::vertex_descriptor,
+    const auto vertex_index_map = boost::get(boost::vertex_index, graph);
+
+    std::vector<
         typename boost::graph_traits<Graph>::degree_size_type
-    > vertex_descriptor_to_coreness_map;
+    > vertex_descriptor_to_coreness_map(boost::num_vertices(graph), 0);
 
     std::vector<typename boost::graph_traits<Graph>::vertex_descriptor> vertex_descriptors_in_ascending_order_of_coreness(boost::num_vertices(graph));
 
     std::vector<size_t> start_indices_of_corenesses(boost::num_vertices(graph), 0);
     
-    boost::unordered_map<
-        typename boost::graph_traits<Graph>::vertex_descriptor,
-        size_t
-    > vertex_descriptor_to_index_map;
+    std::vector<size_t> vertex_descriptor_to_index_map(boost::num_vertices(graph), 0);
 
     // initialize each node's coreness to its degree 
 
@@ -47,7 +45,7 @@ template <typename Graph> boost::unordered_map<
             graph
         );
 
-        vertex_descriptor_to_coreness_map[*vertex_iterator] = degree;
+        vertex_descriptor_to_coreness_map[boost::get(vertex_index_map, *vertex_iterator)] = degree;
         ++start_indices_of_corenesses[degree];
     }
 
@@ -69,23 +67,23 @@ template <typename Graph> boost::unordered_map<
 
         size_t index = --start_indices_of_corenesses[degree];
         vertex_descriptors_in_ascending_order_of_coreness[index] = *vertex_iterator;
-        vertex_descriptor_to_index_map[*vertex_iterator] = index;
+        vertex_descriptor_to_index_map[boost::get(vertex_index_map, *vertex_iterator)] = index;
     }
 
     // iteratively update coreness
 
     for (size_t vertex_index = 0; vertex_index < vertex_descriptors_in_ascending_order_of_coreness.size(); ++vertex_index) {
         typename boost::graph_traits<Graph>::vertex_descriptor vertex_descriptor = vertex_descriptors_in_ascending_order_of_coreness[vertex_index];
-        typename boost::graph_traits<Graph>::degree_size_type vertex_coreness = vertex_descriptor_to_coreness_map[vertex_descriptor];
+        typename boost::graph_traits<Graph>::degree_size_type vertex_coreness = vertex_descriptor_to_coreness_map[boost::get(vertex_index_map, vertex_descriptor)];
 
         auto adjacency_begin_and_end = boost::adjacent_vertices(vertex_descriptor, graph);
         auto adjacency_iterator = adjacency_begin_and_end.first, adjacency_end = adjacency_begin_and_end.second;
         for (; adjacency_iterator != adjacency_end; ++adjacency_iterator) {
             typename boost::graph_traits<Graph>::vertex_descriptor adjacent_vertex_descriptor = *adjacency_iterator;
-            typename boost::graph_traits<Graph>::degree_size_type adjacent_vertex_coreness = vertex_descriptor_to_coreness_map[adjacent_vertex_descriptor];
+            typename boost::graph_traits<Graph>::degree_size_type adjacent_vertex_coreness = vertex_descriptor_to_coreness_map[boost::get(vertex_index_map, adjacent_vertex_descriptor)];
 
             if (adjacent_vertex_coreness > vertex_coreness) {
-                size_t adjacent_vertex_index = vertex_descriptor_to_index_map[adjacent_vertex_descriptor];
+                size_t adjacent_vertex_index = vertex_descriptor_to_index_map[boost::get(vertex_index_map, adjacent_vertex_descriptor)];
 
                 size_t first_vertex_with_adjacent_vertex_coreness_index = start_indices_of_corenesses[adjacent_vertex_coreness];
                 typename boost::graph_traits<Graph>::vertex_descriptor first_vertex_with_adjacent_vertex_coreness_descriptor = vertex_descriptors_in_ascending_order_of_coreness[first_vertex_with_adjacent_vertex_coreness_index];
@@ -97,13 +95,13 @@ template <typename Graph> boost::unordered_map<
                     );
 
                     std::swap(
-                        vertex_descriptor_to_index_map[adjacent_vertex_descriptor],
-                        vertex_descriptor_to_index_map[first_vertex_with_adjacent_vertex_coreness_descriptor]
+                        vertex_descriptor_to_index_map[boost::get(vertex_index_map, adjacent_vertex_descriptor)],
+                        vertex_descriptor_to_index_map[boost::get(vertex_index_map, first_vertex_with_adjacent_vertex_coreness_descriptor)]
                     );
                 }
 
                 ++start_indices_of_corenesses[adjacent_vertex_coreness];
-                --vertex_descriptor_to_coreness_map[adjacent_vertex_descriptor];
+                --vertex_descriptor_to_coreness_map[boost::get(vertex_index_map, adjacent_vertex_descriptor)];
             }
         }
     }
@@ -0,0 +1,121 @@
+#ifndef CALCULATE_CORE_NUMBER_IN_FLAT_ARRAYS_HPP
+#define CALCULATE_CORE_NUMBER_IN_FLAT_ARRAYS_HPP
+
+#include <stddef.h>
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <tuple>
+#include <vector>
+
+#include <boost/graph/graph_traits.hpp>
+#include <boost/graph/properties.hpp>
+
+
+// Batagelj and Zaversnik's O(m) core decomposition, as in calculate_core_number(), for graphs whose vertex descriptors are their vertex indices
+// in [0, num_vertices(graph)) (e.g., CSRGraph, or a boost::adjacency_list with vecS vertex storage).
+// All tables are flat vectors of the integer type Index (e.g., uint32_t to halve their footprint compared to size_t):
+//     core_number[v]       the degree of v among the vertices not yet removed, which ends as its core number
+//     vertices[i]          the vertices in ascending order of core_number, i.e., in buckets of the same core_number
+//     positions[v]         the position of v in vertices
+//     bucket_starts[d]     the position of the first vertex with core_number d that is not yet removed
+// Returns the core number of each vertex in a vector indexed by vertex index (vertices not in graph, e.g., filtered out, get 0),
+// and throws std::overflow_error if a vertex index or degree does not fit in Index.
+template <typename Index, typename Graph> std::vector<Index> calculate_core_number_in_flat_arrays(
+    const Graph& graph
+) {
+    const auto vertex_index_map = boost::get(boost::vertex_index, graph);
+
+    const size_t number_of_vertices = boost::num_vertices(graph);
+    if (number_of_vertices > std::numeric_limits<Index>::max()) {
+        throw std::overflow_error("calculate_core_number_in_flat_arrays: too many vertices for the index type");
+    }
+
+    std::vector<Index> core_number(number_of_vertices, 0);
+    std::vector<Index> listed_vertices;
+    listed_vertices.reserve(number_of_vertices);
+
+    // initialize each vertex's core number to its degree
+    Index max_degree = 0;
+
+    typename boost::graph_traits<Graph>::vertex_iterator vertex_iterator, vertex_end;
+    for (std::tie(vertex_iterator, vertex_end) = boost::vertices(graph); vertex_iterator != vertex_end; ++vertex_iterator) {
+        const size_t degree = boost::degree(*vertex_iterator, graph);
+        if (degree > std::numeric_limits<Index>::max()) {
+            throw std::overflow_error("calculate_core_number_in_flat_arrays: a degree does not fit in the index type");
+        }
+
+        const Index vertex = boost::get(vertex_index_map, *vertex_iterator);
+        core_number[vertex] = degree;
+        max_degree = std::max(max_degree, static_cast<Index>(degree));
+
+        listed_vertices.push_back(vertex);
+    }
+
+    const size_t number_of_listed_vertices = listed_vertices.size();
+
+    // bucket sort the vertices by degree
+    std::vector<Index> bucket_starts(static_cast<size_t>(max_degree) + 2, 0);
+    for (const Index vertex: listed_vertices) {
+        ++bucket_starts[core_number[vertex] + 1];
+    }
+    std::partial_sum(bucket_starts.begin(), bucket_starts.end(), bucket_starts.begin());
+
+    std::vector<Index> vertices(number_of_listed_vertices);
+    std::vector<Index> positions(number_of_vertices, 0);
+    for (const Index vertex: listed_vertices) {
+        const Index position = bucket_starts[core_number[vertex]]++;
+        vertices[position] = vertex;
+        positions[vertex] = position;
+    }
+
+    listed_vertices = std::vector<Index>();
+
+    // placing the vertices moved each bucket start to the start of the next bucket
+    for (size_t degree = static_cast<size_t>(max_degree) + 1; degree > 0; --degree) {
+        bucket_starts[degree] = bucket_starts[degree - 1];
+    }
+    bucket_starts[0] = 0;
+
+    // remove the vertices in ascending order of core number, decrementing the core number of each neighbor with a larger one,
+    // which moves the neighbor to the front of its bucket and then shrinks that bucket
+    for (size_t position = 0; position < number_of_listed_vertices; ++position) {
+        const Index vertex = vertices[position];
+        const Index vertex_core_number = core_number[vertex];
+
+        typename boost::graph_traits<Graph>::adjacency_iterator adjacency_iterator, adjacency_end;
+        for (
+            std::tie(adjacency_iterator, adjacency_end) = boost::adjacent_vertices(
+                static_cast<typename boost::graph_traits<Graph>::vertex_descriptor>(vertex),
+                graph
+            );
+            adjacency_iterator != adjacency_end;
+            ++adjacency_iterator
+        ) {
+            const Index adjacent_vertex = boost::get(vertex_index_map, *adjacency_iterator);
+            const Index adjacent_vertex_core_number = core_number[adjacent_vertex];
+
+            if (adjacent_vertex_core_number > vertex_core_number) {
+                const Index adjacent_vertex_position = positions[adjacent_vertex];
+                const Index bucket_start = bucket_starts[adjacent_vertex_core_number];
+                const Index first_vertex_in_bucket = vertices[bucket_start];
+
+                if (adjacent_vertex != first_vertex_in_bucket) {
+                    vertices[adjacent_vertex_position] = first_vertex_in_bucket;
+                    positions[first_vertex_in_bucket] = adjacent_vertex_position;
+                    vertices[bucket_start] = adjacent_vertex;
+                    positions[adjacent_vertex] = bucket_start;
+                }
+
+                ++bucket_starts[adjacent_vertex_core_number];
+                --core_number[adjacent_vertex];
+            }
+        }
+    }
+
+    return core_number;
+}
+
+#endif
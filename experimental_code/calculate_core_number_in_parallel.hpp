@@ -0,0 +1,162 @@
+#ifndef CALCULATE_CORE_NUMBER_IN_PARALLEL_HPP
+#define CALCULATE_CORE_NUMBER_IN_PARALLEL_HPP
+
+/**
+ * https://doi.org/10.1109/IPDPSW.2017.151 (PKC: parallel k-core decomposition)
+ * https://doi.org/10.1109/BigData.2014.7004366 (ParK)
+ */
+
+#include <stddef.h>
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <stdexcept>
+#include <tuple>
+#include <vector>
+
+#include <boost/asio/post.hpp>
+#include <boost/asio/thread_pool.hpp>
+#include <boost/graph/graph_traits.hpp>
+#include <boost/graph/properties.hpp>
+
+#include "barrier.hpp"
+
+
+// Level-synchronous peeling in the style of PKC, for graphs whose vertex descriptors are their vertex indices
+// in [0, num_vertices(graph)), all of which are vertices of graph (e.g., CSRGraph).
+// Each thread owns a contiguous range of vertices. At level l, it first lists the remaining vertices of its range with degree l
+// in its own buffer, then, after all threads have listed theirs, removes the vertices of its buffer, atomically decrementing
+// the degree of each neighbor with a larger degree and appending the neighbors whose degree drops to l to its buffer.
+// A decrement that finds the degree already at most l (the neighbor was removed concurrently) is undone.
+// The degree of each vertex when it is removed is its core number, which is unique, so the result equals calculate_core_number()
+// (and calculate_core_number_in_flat_arrays()) for any number_of_threads.
+// Returns the core number of each vertex in a vector indexed by vertex index,
+// and throws std::overflow_error if a vertex index or degree does not fit in Index.
+template <typename Index, typename Graph> std::vector<Index> calculate_core_number_in_parallel(
+    const Graph& graph,
+    const unsigned int number_of_threads
+) {
+    typedef typename boost::graph_traits<Graph>::vertex_descriptor VertexDescriptor;
+
+    const auto vertex_index_map = boost::get(boost::vertex_index, graph);
+
+    const size_t number_of_vertices = boost::num_vertices(graph);
+    if (number_of_vertices > std::numeric_limits<Index>::max()) {
+        throw std::overflow_error("calculate_core_number_in_parallel: too many vertices for the index type");
+    }
+
+    std::vector<std::atomic<Index>> degrees(number_of_vertices);
+
+    typename boost::graph_traits<Graph>::vertex_iterator vertex_iterator, vertex_end;
+    for (std::tie(vertex_iterator, vertex_end) = boost::vertices(graph); vertex_iterator != vertex_end; ++vertex_iterator) {
+        const size_t degree = boost::degree(*vertex_iterator, graph);
+        if (degree >= std::numeric_limits<Index>::max()) {
+            throw std::overflow_error("calculate_core_number_in_parallel: a degree does not fit in the index type");
+        }
+
+        degrees[boost::get(vertex_index_map, *vertex_iterator)].store(degree, std::memory_order_relaxed);
+    }
+
+    const size_t number_of_tasks = std::max<size_t>(std::min<size_t>(number_of_threads, number_of_vertices), 1);
+
+    std::atomic<size_t> number_of_removed_vertices(0);
+    Barrier barrier(number_of_tasks);
+
+    // the thread pool has one thread per task, as every task waits for the others at each level
+    boost::asio::thread_pool thread_pool(number_of_tasks);
+
+    for (size_t task_index = 0; task_index < number_of_tasks; ++task_index) {
+        const size_t inclusive_start_vertex = number_of_vertices * task_index / number_of_tasks;
+        const size_t exclusive_end_vertex = number_of_vertices * (task_index + 1) / number_of_tasks;
+
+        boost::asio::post(
+            thread_pool,
+            [
+                &graph,
+                &vertex_index_map,
+                number_of_vertices,
+                &degrees,
+                &number_of_removed_vertices,
+                &barrier,
+                inclusive_start_vertex,
+                exclusive_end_vertex
+            ]() {
+                // the vertices of the range not yet removed, which shrinks as the levels are scanned
+                std::vector<Index> remaining_vertices;
+                remaining_vertices.reserve(exclusive_end_vertex - inclusive_start_vertex);
+                for (size_t vertex = inclusive_start_vertex; vertex < exclusive_end_vertex; ++vertex) {
+                    remaining_vertices.push_back(vertex);
+                }
+
+                std::vector<Index> buffer;
+
+                for (Index level = 0; ; ++level) {
+                    // list the remaining vertices with degree level, and drop those removed at lower levels
+                    buffer.clear();
+
+                    size_t number_of_still_remaining_vertices = 0;
+                    for (const Index vertex: remaining_vertices) {
+                        const Index degree = degrees[vertex].load(std::memory_order_relaxed);
+
+                        if (degree == level) {
+                            buffer.push_back(vertex);
+                        }
+                        else if (degree > level) {
+                            remaining_vertices[number_of_still_remaining_vertices++] = vertex;
+                        }
+                    }
+                    remaining_vertices.resize(number_of_still_remaining_vertices);
+
+                    // no thread decrements a degree before every thread has listed its vertices, which are then listed exactly once
+                    barrier.arrive_and_wait();
+
+                    for (size_t buffer_index = 0; buffer_index < buffer.size(); ++buffer_index) {
+                        typename boost::graph_traits<Graph>::adjacency_iterator adjacency_iterator, adjacency_end;
+                        for (
+                            std::tie(adjacency_iterator, adjacency_end) = boost::adjacent_vertices(
+                                static_cast<VertexDescriptor>(buffer[buffer_index]),
+                                graph
+                            );
+                            adjacency_iterator != adjacency_end;
+                            ++adjacency_iterator
+                        ) {
+                            std::atomic<Index>& adjacent_vertex_degree = degrees[boost::get(vertex_index_map, *adjacency_iterator)];
+
+                            if (adjacent_vertex_degree.load(std::memory_order_relaxed) > level) {
+                                const Index previous_degree = adjacent_vertex_degree.fetch_sub(1, std::memory_order_relaxed);
+
+                                if (previous_degree == level + 1) {
+                                    buffer.push_back(boost::get(vertex_index_map, *adjacency_iterator));
+                                }
+                                else if (previous_degree <= level) {
+                                    adjacent_vertex_degree.fetch_add(1, std::memory_order_relaxed);
+                                }
+                            }
+                        }
+                    }
+
+                    number_of_removed_vertices.fetch_add(buffer.size(), std::memory_order_relaxed);
+
+                    // every thread reads the same number of removed vertices, which no thread updates again before the next barrier
+                    barrier.arrive_and_wait();
+
+                    if (number_of_removed_vertices.load(std::memory_order_relaxed) == number_of_vertices) {
+                        break;
+                    }
+                }
+            }
+        );
+    }
+
+    thread_pool.join();
+
+    std::vector<Index> core_number(number_of_vertices);
+    for (size_t vertex = 0; vertex < number_of_vertices; ++vertex) {
+        core_number[vertex] = degrees[vertex].load(std::memory_order_relaxed);
+    }
+
+    return core_number;
+}
+
+#endif
@@ -9,68 +9,103 @@
  * https://en.cppreference.com/w/cpp/utility/tuple/ignore
  */
 
+#include <math.h>
+
 #include <algorithm>
+#include <atomic>
 #include <tuple>
 #include <utility>
 #include <vector>
 
+#include <boost/asio/post.hpp>
+#include <boost/asio/thread_pool.hpp>
 #include <boost/graph/adjacency_list.hpp>
 #include <boost/graph/graph_traits.hpp>
-#include <boost/unordered_set.hpp>
-#include <boost/unordered_map.hpp>
 
 #include <exception>
 #include <iostream>
 
+#include "assign_edge_indices.hpp"
+#include "split_into_chunks_of_similar_cost.hpp"
+
+
+// Orders (similarity, position in the out-edge list, edge descriptor) tuples so that more similar neighbors come first.
+// Undefined (NaN) similarities come last, and ties are broken by the position in the out-edge list,
+// so that the m most similar neighbors of a vertex are well defined and nested across values of m.
+template <typename EdgeDescriptor> bool is_more_similar_neighbor(
+    const std::tuple<double, size_t, EdgeDescriptor>& first,
+    const std::tuple<double, size_t, EdgeDescriptor>& second
+) {
+    const bool is_first_similarity_undefined = std::isnan(std::get<0>(first));
+    const bool is_second_similarity_undefined = std::isnan(std::get<0>(second));
+
+    if (is_first_similarity_undefined != is_second_similarity_undefined) {
+        return is_second_similarity_undefined;
+    }
+    else if (!is_first_similarity_undefined && std::get<0>(first) != std::get<0>(second)) {
+        return std::get<0>(first) > std::get<0>(second);
+    }
+    else {
+        return std::get<1>(first) < std::get<1>(second);
+    }
+}
+
 
+// Selects, starting from the vertices marked in is_remaining, the edges that are among the m most similar neighbors of both of their endpoints.
+// Vertices are visited layer by layer from each remaining vertex, and per-edge and per-vertex state is kept in vectors
+// indexed by edge index and vertex index.
 template <
     typename Graph,
     typename TrajectoryDataset,
     typename CalculateTrajectorySimilarity
-> boost::unordered_set<typename boost::graph_traits<Graph>::edge_descriptor> calculate_filtered_edge_set(
+> std::vector<bool> calculate_filtered_edge_set_from_remaining_vertices(
     const Graph& social_network,
     const TrajectoryDataset& trajectory_dataset,
     const CalculateTrajectorySimilarity& calculate_trajectory_similarity,
-    const size_t m
+    const size_t m,
+    std::vector<bool>& is_remaining
 ) {
-    boost::unordered_set<
-        typename boost::graph_traits<Graph>::edge_descriptor
-    > selected, singly_checked;
+    const auto edge_index_map = boost::get(boost::edge_index, social_network);
+    const auto vertex_index_map = boost::get(boost::vertex_index, social_network);
 
-    boost::unordered_map<
-        typename boost::graph_traits<Graph>::edge_descriptor,
-        double
-    > similarities;
-    
-    typename boost::graph_traits<Graph>::vertex_iterator vertex_begin, vertex_end;
-    std::tie(vertex_begin, vertex_end) = boost::vertices(social_network);
+    std::vector<bool> selected(boost::num_edges(social_network), false), singly_checked(boost::num_edges(social_network), false);
+
+    std::vector<double> similarities(boost::num_edges(social_network));
+    std::vector<bool> is_similarity_calculated(boost::num_edges(social_network), false);
 
-    boost::unordered_set<
+    std::vector<
         typename boost::graph_traits<Graph>::vertex_descriptor
-    > remaining_vertices(vertex_begin, vertex_end);
+    > current_layer, next_layer;
+    std::vector<bool> is_in_current_layer(boost::num_vertices(social_network), false), is_in_next_layer(boost::num_vertices(social_network), false);
 
-    while (remaining_vertices.size()) {
-        typename boost::graph_traits<Graph>::vertex_descriptor v = *(remaining_vertices.begin());
-        remaining_vertices.erase(remaining_vertices.begin());
+    std::vector<
+        std::tuple<
+            double,
+            size_t,
+            typename boost::graph_traits<Graph>::edge_descriptor
+        >
+    > neighbors_and_similarities;
 
-        boost::unordered_set<
-            typename boost::graph_traits<Graph>::vertex_descriptor
-        > current_layer { v };
+    typename boost::graph_traits<Graph>::vertex_iterator vertex_iterator, vertex_end;
+    for (
+        std::tie(vertex_iterator, vertex_end) = boost::vertices(social_network);
+        vertex_iterator != vertex_end;
+        ++vertex_iterator
+    ) {
+        typename boost::graph_traits<Graph>::vertex_descriptor v = *vertex_iterator;
+        if (!is_remaining[boost::get(vertex_index_map, v)]) continue;
+        is_remaining[boost::get(vertex_index_map, v)] = false;
+
+        current_layer.assign(1, v);
+        is_in_current_layer[boost::get(vertex_index_map, v)] = true;
         
         while (current_layer.size()) {
-            boost::unordered_set<
-                typename boost::graph_traits<Graph>::vertex_descriptor
-            > next_layer;
+            next_layer.clear();
             
             for (
                 const typename boost::graph_traits<Graph>::vertex_descriptor& u: current_layer
             ) {
-                std::vector<
-                    std::pair<
-                        double,
-                        typename boost::graph_traits<Graph>::edge_descriptor
-                    >
-                > neighbors_and_similarities;
+                neighbors_and_similarities.clear();
                 
                 typename boost::graph_traits<Graph>::out_edge_iterator out_edge_iterator, out_edge_end;
                 for(
@@ -82,10 +117,11 @@ template <
                     ++out_edge_iterator
                 ) {
                     const typename boost::graph_traits<Graph>::edge_descriptor& uv = *out_edge_iterator;
-                    double trajectory_similarity;
+                    const size_t uv_index = boost::get(edge_index_map, uv);
                     
-                    if (!similarities.count(uv)) {
+                    if (!is_similarity_calculated[uv_index]) {
                         const typename boost::graph_traits<Graph>::vertex_descriptor& v = boost::target(uv, social_network);
+                        double trajectory_similarity;
                         
                         try {
                             trajectory_similarity = calculate_trajectory_similarity(
@@ -97,14 +133,13 @@ template <
                             trajectory_similarity = 0;
                         }
                         
-                        similarities[uv] = trajectory_similarity;
-                    }
-                    else {
-                        trajectory_similarity = similarities[uv];
+                        similarities[uv_index] = trajectory_similarity;
+                        is_similarity_calculated[uv_index] = true;
                     }
                     
                     neighbors_and_similarities.emplace_back(
-                        trajectory_similarity,
+                        similarities[uv_index],
+                        neighbors_and_similarities.size(),
                         uv
                     );
                 }
@@ -118,12 +153,9 @@ template <
                     neighbors_and_similarities.begin(),
                     neighbors_and_similarities.begin() + m_,
                     neighbors_and_similarities.end(),
-                    [](
-                        const auto& first_pair,
-                        const auto& second_pair
-                    ) {
-                        return first_pair.first > second_pair.first;
-                    }
+                    is_more_similar_neighbor<
+                        typename boost::graph_traits<Graph>::edge_descriptor
+                    >
                 );
                 
                 for (
@@ -131,22 +163,27 @@ template <
                     i < m_;
                     ++i
                 ) {
-                    const typename boost::graph_traits<Graph>::edge_descriptor& uv = neighbors_and_similarities[i].second;
+                    const typename boost::graph_traits<Graph>::edge_descriptor& uv = std::get<2>(neighbors_and_similarities[i]);
+                    const size_t uv_index = boost::get(edge_index_map, uv);
                     
-                    if (singly_checked.count(uv)) {
-                        singly_checked.erase(uv);
-                        selected.insert(uv);
+                    if (singly_checked[uv_index]) {
+                        singly_checked[uv_index] = false;
+                        selected[uv_index] = true;
                     }
                     else {
                         const typename boost::graph_traits<Graph>::vertex_descriptor& v = boost::target(uv, social_network);
+                        const size_t v_index = boost::get(vertex_index_map, v);
                         
-                        if (current_layer.count(v)) {
-                            singly_checked.insert(uv);
+                        if (is_in_current_layer[v_index]) {
+                            singly_checked[uv_index] = true;
                         }
                         else {
-                            if (remaining_vertices.count(v)) {
-                                singly_checked.insert(uv);
-                                next_layer.insert(v);
+                            if (is_remaining[v_index]) {
+                                singly_checked[uv_index] = true;
+                                if (!is_in_next_layer[v_index]) {
+                                    is_in_next_layer[v_index] = true;
+                                    next_layer.push_back(v);
+                                }
                             }
                         }
                     }
@@ -156,10 +193,18 @@ template <
             for (
                 const typename boost::graph_traits<Graph>::vertex_descriptor& u: current_layer
             ) {
-                remaining_vertices.erase(u);
+                is_remaining[boost::get(vertex_index_map, u)] = false;
+                is_in_current_layer[boost::get(vertex_index_map, u)] = false;
+            }
+
+            for (
+                const typename boost::graph_traits<Graph>::vertex_descriptor& u: next_layer
+            ) {
+                is_in_next_layer[boost::get(vertex_index_map, u)] = false;
+                is_in_current_layer[boost::get(vertex_index_map, u)] = true;
             }
             
-            current_layer = std::move(next_layer); 
+            std::swap(current_layer, next_layer);
         }
     }
     
@@ -167,12 +212,36 @@ template <
 }
 
 
+// Returns the filtered edge set for m as a vector indexed by edge index (see assign_edge_indices.hpp).
+template <
+    typename Graph,
+    typename TrajectoryDataset,
+    typename CalculateTrajectorySimilarity
+> std::vector<bool> calculate_filtered_edge_set(
+    const Graph& social_network,
+    const TrajectoryDataset& trajectory_dataset,
+    const CalculateTrajectorySimilarity& calculate_trajectory_similarity,
+    const size_t m
+) {
+    std::vector<bool> is_remaining(boost::num_vertices(social_network), true);
+
+    return calculate_filtered_edge_set_from_remaining_vertices(
+        social_network,
+        trajectory_dataset,
+        calculate_trajectory_similarity,
+        m,
+        is_remaining
+    );
+}
+
+
+// Returns the filtered edge set for m as a vector indexed by edge index, starting only from vertices with coreness above k.
 template <
     typename Graph,
     typename VertexDescriptorToCorenessMap,
     typename TrajectoryDataset,
     typename CalculateTrajectorySimilarity
-> boost::unordered_set<typename boost::graph_traits<Graph>::edge_descriptor> calculate_filtered_edge_set(
+> std::vector<bool> calculate_filtered_edge_set(
     const Graph& social_network,
     const VertexDescriptorToCorenessMap& vertex_descriptor_to_coreness_map,
     const TrajectoryDataset& trajectory_dataset,
@@ -180,145 +249,461 @@ template <
     const size_t k,
     const size_t m
 ) {
-    boost::unordered_set<
+    const auto vertex_index_map = boost::get(boost::vertex_index, social_network);
+
+    std::vector<bool> is_remaining(boost::num_vertices(social_network), false);
+
+    typename boost::graph_traits<Graph>::vertex_iterator vertex_iterator, vertex_end;
+    for (
+        std::tie(vertex_iterator, vertex_end) = boost::vertices(social_network);
+        vertex_iterator != vertex_end;
+        ++vertex_iterator
+    ) {
+        is_remaining[boost::get(vertex_index_map, *vertex_iterator)] = vertex_descriptor_to_coreness_map[boost::get(vertex_index_map, *vertex_iterator)] > k;
+    }
+
+    return calculate_filtered_edge_set_from_remaining_vertices(
+        social_network,
+        trajectory_dataset,
+        calculate_trajectory_similarity,
+        m,
+        is_remaining
+    );
+}
+
+
+// Calculates, for each edge uv, the smallest m for which uv is among the m most similar neighbors of both u and v,
+// i.e., max(rank of uv at u, rank of uv at v) + 1.
+// As the filtered edge set for m consists of the edges whose selection threshold is at most m,
+// filtered edge sets for multiple values of m can be built incrementally from the returned edges,
+// which are sorted in ascending order of selection threshold (and of edge index among equal selection thresholds).
+template <
+    typename Graph,
+    typename TrajectoryDataset,
+    typename CalculateTrajectorySimilarity
+> std::vector<
+    std::pair<
+        size_t,
         typename boost::graph_traits<Graph>::edge_descriptor
-    > selected, singly_checked;
+    >
+> calculate_edges_in_ascending_order_of_selection_threshold(
+    const Graph& social_network,
+    const TrajectoryDataset& trajectory_dataset,
+    const CalculateTrajectorySimilarity& calculate_trajectory_similarity
+) {
+    const auto edge_index_map = boost::get(boost::edge_index, social_network);
 
-    boost::unordered_map<
-        typename boost::graph_traits<Graph>::edge_descriptor,
-        double
-    > similarities;
-    
-    typename boost::graph_traits<Graph>::vertex_iterator vertex_begin, vertex_end;
-    std::tie(vertex_begin, vertex_end) = boost::vertices(social_network);
+    std::vector<double> similarities(boost::num_edges(social_network));
+    std::vector<bool> is_similarity_calculated(boost::num_edges(social_network), false);
 
-    boost::unordered_set<
-        typename boost::graph_traits<Graph>::vertex_descriptor
-    > remaining_vertices;
-    std::copy_if(
-        vertex_begin,
-        vertex_end,
-        std::inserter(remaining_vertices, remaining_vertices.end()),
-        [&vertex_descriptor_to_coreness_map, k](const typename boost::graph_traits<Graph>::vertex_descriptor& vertex_descriptor) {
-            return vertex_descriptor_to_coreness_map.at(vertex_descriptor) > k;
+    std::vector<size_t> selection_thresholds(boost::num_edges(social_network), 0);
+
+    std::vector<
+        std::tuple<
+            double,
+            size_t,
+            typename boost::graph_traits<Graph>::edge_descriptor
+        >
+    > neighbors_and_similarities;
+
+    typename boost::graph_traits<Graph>::vertex_iterator vertex_iterator, vertex_end;
+    for (
+        std::tie(vertex_iterator, vertex_end) = boost::vertices(social_network);
+        vertex_iterator != vertex_end;
+        ++vertex_iterator
+    ) {
+        const typename boost::graph_traits<Graph>::vertex_descriptor& u = *vertex_iterator;
+
+        neighbors_and_similarities.clear();
+
+        typename boost::graph_traits<Graph>::out_edge_iterator out_edge_iterator, out_edge_end;
+        for (
+            std::tie(out_edge_iterator, out_edge_end) = boost::out_edges(
+                u,
+                social_network
+            );
+            out_edge_iterator != out_edge_end;
+            ++out_edge_iterator
+        ) {
+            const typename boost::graph_traits<Graph>::edge_descriptor& uv = *out_edge_iterator;
+            const size_t uv_index = boost::get(edge_index_map, uv);
+
+            if (!is_similarity_calculated[uv_index]) {
+                const typename boost::graph_traits<Graph>::vertex_descriptor& v = boost::target(uv, social_network);
+                double trajectory_similarity;
+
+                try {
+                    trajectory_similarity = calculate_trajectory_similarity(
+                        trajectory_dataset.at(u),
+                        trajectory_dataset.at(v)
+                    );
+                }
+                catch (std::out_of_range& e) {
+                    trajectory_similarity = 0;
+                }
+
+                similarities[uv_index] = trajectory_similarity;
+                is_similarity_calculated[uv_index] = true;
+            }
+
+            neighbors_and_similarities.emplace_back(
+                similarities[uv_index],
+                neighbors_and_similarities.size(),
+                uv
+            );
+        }
+
+        // rank all neighbors once
+        std::sort(
+            neighbors_and_similarities.begin(),
+            neighbors_and_similarities.end(),
+            is_more_similar_neighbor<
+                typename boost::graph_traits<Graph>::edge_descriptor
+            >
+        );
+
+        for (
+            size_t rank = 0;
+            rank < neighbors_and_similarities.size();
+            ++rank
+        ) {
+            size_t& selection_threshold = selection_thresholds[boost::get(edge_index_map, std::get<2>(neighbors_and_similarities[rank]))];
+            selection_threshold = std::max(selection_threshold, rank + 1);
+        }
+    }
+
+    const std::vector<typename boost::graph_traits<Graph>::edge_descriptor> edges = get_edges_in_ascending_order_of_edge_index(social_network);
+
+    std::vector<
+        std::pair<
+            size_t,
+            typename boost::graph_traits<Graph>::edge_descriptor
+        >
+    > edges_in_ascending_order_of_selection_threshold;
+
+    for (size_t edge_index = 0; edge_index < edges.size(); ++edge_index) {
+        edges_in_ascending_order_of_selection_threshold.emplace_back(
+            selection_thresholds[edge_index],
+            edges[edge_index]
+        );
+    }
+
+    std::stable_sort(
+        edges_in_ascending_order_of_selection_threshold.begin(),
+        edges_in_ascending_order_of_selection_threshold.end(),
+        [](
+            const auto& first_pair,
+            const auto& second_pair
+        ) {
+            return first_pair.first < second_pair.first;
         }
     );
 
-    while (remaining_vertices.size()) {
-        typename boost::graph_traits<Graph>::vertex_descriptor v = *(remaining_vertices.begin());
-        remaining_vertices.erase(remaining_vertices.begin());
+    return edges_in_ascending_order_of_selection_threshold;
+}
 
-        boost::unordered_set<
-            typename boost::graph_traits<Graph>::vertex_descriptor
-        > current_layer { v };
-        
-        while (current_layer.size()) {
-            boost::unordered_set<
-                typename boost::graph_traits<Graph>::vertex_descriptor
-            > next_layer;
-            
-            for (
-                const typename boost::graph_traits<Graph>::vertex_descriptor& u: current_layer
-            ) {
-                std::vector<
-                    std::pair<
-                        double,
-                        typename boost::graph_traits<Graph>::edge_descriptor
-                    >
-                > neighbors_and_similarities;
-                
-                typename boost::graph_traits<Graph>::out_edge_iterator out_edge_iterator, out_edge_end;
-                for(
-                    std::tie(out_edge_iterator, out_edge_end) = boost::out_edges(
-                        u,
-                        social_network
-                    );
-                    out_edge_iterator != out_edge_end;
-                    ++out_edge_iterator
-                ) {
-                    const typename boost::graph_traits<Graph>::edge_descriptor& uv = *out_edge_iterator;
+
+// Calculates the trajectory similarities of edges on number_of_threads threads, returning them in the order of edges.
+// Edges are scheduled in chunks of similar cost, estimated with the lengths of the trajectories of their endpoints.
+// calculate_trajectory_similarity is assumed to be symmetric (as trajectory_similarity() is),
+// so that the similarities are identical to those calculated sequentially.
+template <
+    typename Graph,
+    typename TrajectoryDataset,
+    typename CalculateTrajectorySimilarity
+> std::vector<double> calculate_edge_similarities_in_parallel(
+    const Graph& social_network,
+    const std::vector<typename boost::graph_traits<Graph>::edge_descriptor>& edges,
+    const TrajectoryDataset& trajectory_dataset,
+    const CalculateTrajectorySimilarity& calculate_trajectory_similarity,
+    const size_t number_of_threads
+) {
+    const auto get_trajectory_length = [&trajectory_dataset](const typename boost::graph_traits<Graph>::vertex_descriptor& v) -> size_t {
+        try {
+            return trajectory_dataset.at(v).size();
+        }
+        catch (std::out_of_range& e) {
+            return 0;
+        }
+    };
+
+    const std::vector<size_t> chunk_offsets = split_into_chunks_of_similar_cost(
+        edges.size(),
+        [&social_network, &edges, &get_trajectory_length](const size_t edge_index) {
+            return 1 + get_trajectory_length(boost::source(edges[edge_index], social_network)) + get_trajectory_length(boost::target(edges[edge_index], social_network));
+        },
+        16 * number_of_threads
+    );
+
+    std::vector<double> similarities(edges.size());
+
+    boost::asio::thread_pool thread_pool(number_of_threads);
+
+    for (size_t chunk_index = 0; chunk_index + 1 < chunk_offsets.size(); ++chunk_index) {
+        const size_t inclusive_start_edge_index = chunk_offsets[chunk_index], exclusive_end_edge_index = chunk_offsets[chunk_index + 1];
+
+        boost::asio::post(
+            thread_pool,
+            [
+                &social_network,
+                &edges,
+                &trajectory_dataset,
+                &calculate_trajectory_similarity,
+                &similarities,
+                inclusive_start_edge_index,
+                exclusive_end_edge_index
+            ]() {
+                for (size_t edge_index = inclusive_start_edge_index; edge_index < exclusive_end_edge_index; ++edge_index) {
+                    const typename boost::graph_traits<Graph>::edge_descriptor& uv = edges[edge_index];
                     double trajectory_similarity;
-                    
-                    if (!similarities.count(uv)) {
-                        const typename boost::graph_traits<Graph>::vertex_descriptor& v = boost::target(uv, social_network);
-                        
-                        try {
-                            trajectory_similarity = calculate_trajectory_similarity(
-                                trajectory_dataset.at(u),
-                                trajectory_dataset.at(v)
-                            );
-                        }
-                        catch (std::out_of_range& e) {
-                            trajectory_similarity = 0;
-                        }
-                        
-                        similarities[uv] = trajectory_similarity;
+
+                    try {
+                        trajectory_similarity = calculate_trajectory_similarity(
+                            trajectory_dataset.at(boost::source(uv, social_network)),
+                            trajectory_dataset.at(boost::target(uv, social_network))
+                        );
                     }
-                    else {
-                        trajectory_similarity = similarities[uv];
+                    catch (std::out_of_range& e) {
+                        trajectory_similarity = 0;
                     }
-                    
-                    neighbors_and_similarities.emplace_back(
-                        trajectory_similarity,
-                        uv
-                    );
+
+                    similarities[edge_index] = trajectory_similarity;
                 }
+            }
+        );
+    }
 
-                size_t m_ = std::min(
-                    m,
-                    neighbors_and_similarities.size()
-                );
-                
-                std::partial_sort(
-                    neighbors_and_similarities.begin(),
-                    neighbors_and_similarities.begin() + m_,
-                    neighbors_and_similarities.end(),
-                    [](
-                        const auto& first_pair,
-                        const auto& second_pair
+    thread_pool.join();
+
+    return similarities;
+}
+
+
+// Calls rank_neighbors(u, neighbors_and_similarities) for each vertex u on number_of_threads threads,
+// where neighbors_and_similarities holds (similarity, position in the out-edge list, edge index) tuples in out-edge order,
+// and similarities are indexed by edge index.
+// Vertices are scheduled in chunks of similar total degree.
+template <
+    typename Graph,
+    typename EdgeIndexMap,
+    typename RankNeighbors
+> void rank_neighbors_in_parallel(
+    const Graph& social_network,
+    const EdgeIndexMap& edge_index_map,
+    const std::vector<double>& similarities,
+    const RankNeighbors& rank_neighbors,
+    const size_t number_of_threads
+) {
+    typename boost::graph_traits<Graph>::vertex_iterator vertex_begin, vertex_end;
+    std::tie(vertex_begin, vertex_end) = boost::vertices(social_network);
+
+    const std::vector<typename boost::graph_traits<Graph>::vertex_descriptor> vertices(vertex_begin, vertex_end);
+
+    const std::vector<size_t> chunk_offsets = split_into_chunks_of_similar_cost(
+        vertices.size(),
+        [&social_network, &vertices](const size_t vertex_index) {
+            return 1 + boost::out_degree(vertices[vertex_index], social_network);
+        },
+        16 * number_of_threads
+    );
+
+    boost::asio::thread_pool thread_pool(number_of_threads);
+
+    for (size_t chunk_index = 0; chunk_index + 1 < chunk_offsets.size(); ++chunk_index) {
+        const size_t inclusive_start_vertex_index = chunk_offsets[chunk_index], exclusive_end_vertex_index = chunk_offsets[chunk_index + 1];
+
+        boost::asio::post(
+            thread_pool,
+            [
+                &social_network,
+                &edge_index_map,
+                &similarities,
+                &rank_neighbors,
+                &vertices,
+                inclusive_start_vertex_index,
+                exclusive_end_vertex_index
+            ]() {
+                std::vector<std::tuple<double, size_t, size_t>> neighbors_and_similarities;
+
+                for (size_t vertex_index = inclusive_start_vertex_index; vertex_index < exclusive_end_vertex_index; ++vertex_index) {
+                    const typename boost::graph_traits<Graph>::vertex_descriptor& u = vertices[vertex_index];
+
+                    neighbors_and_similarities.clear();
+
+                    typename boost::graph_traits<Graph>::out_edge_iterator out_edge_iterator, out_edge_end;
+                    for (
+                        std::tie(out_edge_iterator, out_edge_end) = boost::out_edges(
+                            u,
+                            social_network
+                        );
+                        out_edge_iterator != out_edge_end;
+                        ++out_edge_iterator
                     ) {
-                        return first_pair.first > second_pair.first;
-                    }
-                );
-                
-                for (
-                    size_t i = 0;
-                    i < m_;
-                    ++i
-                ) {
-                    const typename boost::graph_traits<Graph>::edge_descriptor& uv = neighbors_and_similarities[i].second;
-                    
-                    if (singly_checked.count(uv)) {
-                        singly_checked.erase(uv);
-                        selected.insert(uv);
-                    }
-                    else {
-                        const typename boost::graph_traits<Graph>::vertex_descriptor& v = boost::target(uv, social_network);
-                        
-                        if (current_layer.count(v)) {
-                            singly_checked.insert(uv);
-                        }
-                        else {
-                            if (remaining_vertices.count(v)) {
-                                singly_checked.insert(uv);
-                                next_layer.insert(v);
-                            }
-                        }
+                        const size_t edge_index = boost::get(edge_index_map, *out_edge_iterator);
+
+                        neighbors_and_similarities.emplace_back(
+                            similarities[edge_index],
+                            neighbors_and_similarities.size(),
+                            edge_index
+                        );
                     }
+
+                    rank_neighbors(u, neighbors_and_similarities);
                 }
             }
-            
-            for (
-                const typename boost::graph_traits<Graph>::vertex_descriptor& u: current_layer
-            ) {
-                remaining_vertices.erase(u);
+        );
+    }
+
+    thread_pool.join();
+}
+
+
+// Parallel version of calculate_filtered_edge_set(), returning an identical edge set.
+// First, all edge similarities are calculated on a thread pool.
+// Then, the m most similar neighbors of each vertex are found in parallel,
+// and the edges that are among the m most similar neighbors of both of their endpoints are selected.
+template <
+    typename Graph,
+    typename TrajectoryDataset,
+    typename CalculateTrajectorySimilarity
+> std::vector<bool> calculate_filtered_edge_set_in_parallel(
+    const Graph& social_network,
+    const TrajectoryDataset& trajectory_dataset,
+    const CalculateTrajectorySimilarity& calculate_trajectory_similarity,
+    const size_t m,
+    const size_t number_of_threads
+) {
+    const std::vector<typename boost::graph_traits<Graph>::edge_descriptor> edges = get_edges_in_ascending_order_of_edge_index(social_network);
+
+    const std::vector<double> similarities = calculate_edge_similarities_in_parallel(
+        social_network,
+        edges,
+        trajectory_dataset,
+        calculate_trajectory_similarity,
+        number_of_threads
+    );
+
+    // count the endpoints (0, 1, or 2) having each edge among their m most similar neighbors
+    std::vector<std::atomic<unsigned char>> numbers_of_selecting_endpoints(edges.size());
+
+    rank_neighbors_in_parallel(
+        social_network,
+        boost::get(boost::edge_index, social_network),
+        similarities,
+        [m, &numbers_of_selecting_endpoints](
+            const typename boost::graph_traits<Graph>::vertex_descriptor&,
+            std::vector<std::tuple<double, size_t, size_t>>& neighbors_and_similarities
+        ) {
+            size_t m_ = std::min(
+                m,
+                neighbors_and_similarities.size()
+            );
+
+            std::partial_sort(
+                neighbors_and_similarities.begin(),
+                neighbors_and_similarities.begin() + m_,
+                neighbors_and_similarities.end(),
+                is_more_similar_neighbor<size_t>
+            );
+
+            for (size_t i = 0; i < m_; ++i) {
+                ++numbers_of_selecting_endpoints[std::get<2>(neighbors_and_similarities[i])];
             }
-            
-            current_layer = std::move(next_layer); 
-        }
+        },
+        number_of_threads
+    );
+
+    std::vector<bool> selected(edges.size(), false);
+
+    for (size_t edge_index = 0; edge_index < edges.size(); ++edge_index) {
+        selected[edge_index] = numbers_of_selecting_endpoints[edge_index] == 2;
     }
-    
+
     return selected;
 }
 
+
+// Parallel version of calculate_edges_in_ascending_order_of_selection_threshold(), returning identical selection thresholds.
+template <
+    typename Graph,
+    typename TrajectoryDataset,
+    typename CalculateTrajectorySimilarity
+> std::vector<
+    std::pair<
+        size_t,
+        typename boost::graph_traits<Graph>::edge_descriptor
+    >
+> calculate_edges_in_ascending_order_of_selection_threshold_in_parallel(
+    const Graph& social_network,
+    const TrajectoryDataset& trajectory_dataset,
+    const CalculateTrajectorySimilarity& calculate_trajectory_similarity,
+    const size_t number_of_threads
+) {
+    const std::vector<typename boost::graph_traits<Graph>::edge_descriptor> edges = get_edges_in_ascending_order_of_edge_index(social_network);
+
+    const std::vector<double> similarities = calculate_edge_similarities_in_parallel(
+        social_network,
+        edges,
+        trajectory_dataset,
+        calculate_trajectory_similarity,
+        number_of_threads
+    );
+
+    std::vector<std::atomic<size_t>> selection_thresholds(edges.size());
+
+    rank_neighbors_in_parallel(
+        social_network,
+        boost::get(boost::edge_index, social_network),
+        similarities,
+        [&selection_thresholds](
+            const typename boost::graph_traits<Graph>::vertex_descriptor&,
+            std::vector<std::tuple<double, size_t, size_t>>& neighbors_and_similarities
+        ) {
+            std::sort(
+                neighbors_and_similarities.begin(),
+                neighbors_and_similarities.end(),
+                is_more_similar_neighbor<size_t>
+            );
+
+            for (size_t rank = 0; rank < neighbors_and_similarities.size(); ++rank) {
+                // atomically raise the selection threshold to rank + 1
+                std::atomic<size_t>& selection_threshold = selection_thresholds[std::get<2>(neighbors_and_similarities[rank])];
+                size_t current_selection_threshold = selection_threshold.load();
+                while (
+                    current_selection_threshold < rank + 1 &&
+                    !selection_threshold.compare_exchange_weak(current_selection_threshold, rank + 1)
+                ) { }
+            }
+        },
+        number_of_threads
+    );
+
+    std::vector<
+        std::pair<
+            size_t,
+            typename boost::graph_traits<Graph>::edge_descriptor
+        >
+    > edges_in_ascending_order_of_selection_threshold;
+
+    for (size_t edge_index = 0; edge_index < edges.size(); ++edge_index) {
+        edges_in_ascending_order_of_selection_threshold.emplace_back(
+            selection_thresholds[edge_index].load(),
+            edges[edge_index]
+        );
+    }
+
+    std::stable_sort(
+        edges_in_ascending_order_of_selection_threshold.begin(),
+        edges_in_ascending_order_of_selection_threshold.end(),
+        [](
+            const auto& first_pair,
+            const auto& second_pair
+        ) {
+            return first_pair.first < second_pair.first;
+        }
+    );
+
+    return edges_in_ascending_order_of_selection_threshold;
+}
+
 #endif
@@ -1,3 +1,6 @@
+#include <stdint.h>
+
+#include <algorithm>
 #include <iomanip>
 #include <fstream>
 #include <string>
@@ -5,25 +8,22 @@
 
 #include <argparse/argparse.hpp>
 #include <boost/graph/adjacency_list.hpp>
-#include <boost/graph/filtered_graph.hpp>
 #include <boost/property_map/property_map.hpp>
 #include <boost/unordered_set.hpp>
 #include <boost/unordered_map.hpp>
 
-#include "always_true_predicate.hpp"
-#include "calculate_core_number.hpp"
+// csr_graph.hpp declares the Boost Graph Library functions for CSRGraph, so it precedes the algorithms calling them
+#include "csr_graph.hpp"
+#include "calculate_core_number_in_flat_arrays.hpp"
+#include "calculate_core_number_in_parallel.hpp"
 #include "does_vertex_descriptor_coreness_satisfy_requirement.hpp"
-#include "read_adjacency_list.hpp"
+#include "filter_csr_graph.hpp"
+#include "parse_comma_separated_values.hpp"
 #include "write_edge_list.hpp"
 
 
 // Graph typedefs
-typedef boost::adjacency_list<
-    boost::vecS,
-    boost::vecS,
-    boost::undirectedS,
-    boost::property<boost::vertex_name_t, std::string>
-> Graph;
+typedef CSRGraph Graph;
 typedef boost::graph_traits<Graph>::vertex_descriptor VertexDescriptor;
 typedef boost::graph_traits<Graph>::edge_descriptor EdgeDescriptor;
 typedef boost::graph_traits<Graph>::degree_size_type DegreeSizeType;
@@ -34,7 +34,9 @@ void parse_command_line_arguments(
     const char** argv,
     std::string& input_graph_path,
     unsigned int& k,
-    std::string& output_path
+    std::vector<unsigned int>& k_values,
+    std::string& output_path,
+    unsigned int& number_of_threads
 ) {
     // To start parsing command-line arguments, create an ArgumentParser
     argparse::ArgumentParser parser("");
@@ -55,13 +57,21 @@ void parse_command_line_arguments(
         .help("specify the input graph (an adjacency list)");
 
     parser.add_argument("-k", "--k")
-        .required()
         .scan<'u', unsigned int>()
         .help("specify the value of k");
     
+    // Alternatively, output the k-cores for multiple values of k, calculating core numbers only once
+    parser.add_argument("--k-values")
+        .help("specify a comma separated list of values of k (e.g., 3,5,7), instead of -k");
+    
     parser.add_argument("-o", "--output")
         .required()
-        .help("specify the output file (an adjacency list)");
+        .help("specify the output file (an adjacency list), or, with --k-values, the output directory (containing one output file for each k)");
+    
+    parser.add_argument("--threads")
+        .default_value<unsigned int>(1)
+        .scan<'u', unsigned int>()
+        .help("the number of threads calculating core numbers");
     
     // Parse arguments
     try {
@@ -76,8 +86,33 @@ void parse_command_line_arguments(
     
     // Use arguments
     input_graph_path = parser.get<std::string>("--graph");
-    k = parser.get<unsigned int>("--k");
     output_path = parser.get<std::string>("--output");
+    number_of_threads = std::max(parser.get<unsigned int>("--threads"), 1u);
+    
+    // Exactly one of -k and --k-values is required
+    const auto optional_k = parser.present<unsigned int>("--k");
+    const auto optional_k_values = parser.present<std::string>("--k-values");
+    
+    try {
+        if (optional_k && !optional_k_values) {
+            k = *optional_k;
+        }
+        else if (!optional_k && optional_k_values) {
+            k_values = parse_comma_separated_values<unsigned int>(*optional_k_values);
+            
+            if (k_values.empty()) {
+                throw std::runtime_error("--k-values: no values of k given");
+            }
+        }
+        else {
+            throw std::runtime_error("exactly one of -k and --k-values is required");
+        }
+    }
+    catch (const std::runtime_error& e) {
+        std::cerr << e.what() << '\n';
+        std::cerr << parser;
+        exit(EXIT_FAILURE);
+    }
 }
 
 
@@ -85,50 +120,61 @@ int main(int argc, const char* argv[]) {
     // parse command line arguments
     std::string input_graph_path;
     unsigned int k;
+    std::vector<unsigned int> k_values;
     std::string output_path;
+    unsigned int number_of_threads;
     
     parse_command_line_arguments(
         argc,
         argv,
         input_graph_path,
         k,
-        output_path
+        k_values,
+        output_path,
+        number_of_threads
     );
     
     // load input graph
-    Graph graph;
     boost::unordered_map<std::string, VertexDescriptor> string_to_vertex_descriptor_map;
     
-    std::ifstream input_file_stream(input_graph_path);
-    read_adjacency_list<boost::vertex_name_t>(
-        graph,
+    const Graph graph = load_csr_graph(
         string_to_vertex_descriptor_map,
-        input_file_stream
+        input_graph_path
     );
     
     // calculate core number
-    boost::unordered_map<VertexDescriptor, DegreeSizeType> core_number = calculate_core_number(graph);
+    std::vector<uint32_t> core_number = (number_of_threads > 1) ?
+        calculate_core_number_in_parallel<uint32_t>(graph, number_of_threads) :
+        calculate_core_number_in_flat_arrays<uint32_t>(graph);
 
-    // create graph_filtered_with_edge_predicate_and_vertex_predicate
-    AlwaysTruePredicate edge_predicate;
+    // with --k-values, the k-cores are written to <output>/<k>
+    const bool is_sweeping_k = !k_values.empty();
 
-    DoesVertexDescriptorCorenessSatisfyRequirement<decltype(core_number), DegreeSizeType> vertex_predicate(
-        &core_number,
-        k
-    );
+    if (!is_sweeping_k) {
+        k_values = { k };
+    }
 
-    boost::filtered_graph<Graph, decltype(edge_predicate), decltype(vertex_predicate)> graph_filtered_with_edge_predicate_and_vertex_predicate(
-        graph,
-        edge_predicate,
-        vertex_predicate
-    );
+    for (const unsigned int k: k_values) {
+        // create graph_filtered_with_vertex_predicate, materialized as the subgraph induced by the vertices with coreness of at least k
+        DoesVertexDescriptorCorenessSatisfyRequirement<decltype(core_number), DegreeSizeType> vertex_predicate(
+            &core_number,
+            k
+        );
 
-    // write graph_filtered_with_edge_predicate_and_vertex_predicate
-    std::ofstream output_file_stream(output_path);
-    write_edge_list<boost::vertex_name_t>(
-        graph_filtered_with_edge_predicate_and_vertex_predicate,
-        output_file_stream
-    );
+        const Graph graph_filtered_with_vertex_predicate = filter_csr_graph_vertices(
+            graph,
+            vertex_predicate
+        );
+
+        // write graph_filtered_with_vertex_predicate
+        std::ofstream output_file_stream(
+            is_sweeping_k ? (output_path + '/' + std::to_string(k)) : output_path
+        );
+        write_edge_list<boost::vertex_name_t>(
+            graph_filtered_with_vertex_predicate,
+            output_file_stream
+        );
+    }
     
     return 0;
 }
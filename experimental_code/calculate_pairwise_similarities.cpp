@@ -13,6 +13,7 @@
 #include <boost/property_map/property_map.hpp>
 
 #include "load_trajectory_dataset.hpp"
+#include "parse_comma_separated_values.hpp"
 #include "read_adjacency_list.hpp"
 #include "trajectory_similarity.hpp"
 
@@ -35,7 +36,9 @@ void parse_command_line_arguments(
     std::string& input_graph_path,
     std::string& input_trajectories_path,
     double& tau,
+    std::vector<double>& tau_values,
     double& delta,
+    std::vector<double>& delta_values,
     std::string& output_pairwise_similarities_path
 ) {
     // To start parsing command-line arguments, create an ArgumentParser
@@ -76,9 +79,15 @@ void parse_command_line_arguments(
             "the parameter tau (temporal time constant, in seconds)"
         );
     
+    parser.add_argument("--delta-values")
+        .help("a comma-separated list of values of delta, evaluated in one pass over the closest matches of each pair (defaults to --delta if only --tau-values is given)");
+    
+    parser.add_argument("--tau-values")
+        .help("a comma-separated list of values of tau, evaluated in one pass over the closest matches of each pair (defaults to --tau if only --delta-values is given)");
+    
     parser.add_argument("-o", "--output")
         .required()
-        .help("specify the output file (a CSV file with the columns first_user, second_user, similarity)");
+        .help("specify the output file (a CSV file with the columns first_user, second_user, similarity, or, with --delta-values and/or --tau-values, first_user, second_user, delta, tau, similarity)");
     
     // Parse arguments
     try {
@@ -97,6 +106,25 @@ void parse_command_line_arguments(
     tau = parser.get<double>("--tau");
     delta = parser.get<double>("--delta");
     output_pairwise_similarities_path = parser.get<std::string>("--output");
+    
+    const auto optional_delta_values = parser.present<std::string>("--delta-values");
+    const auto optional_tau_values = parser.present<std::string>("--tau-values");
+    
+    if (optional_delta_values || optional_tau_values) {
+        try {
+            delta_values = optional_delta_values ? parse_comma_separated_values<double>(*optional_delta_values) : std::vector<double> { delta };
+            tau_values = optional_tau_values ? parse_comma_separated_values<double>(*optional_tau_values) : std::vector<double> { tau };
+            
+            if (delta_values.empty() || tau_values.empty()) {
+                throw std::runtime_error("--delta-values and --tau-values must not be empty");
+            }
+        }
+        catch (const std::runtime_error& e) {
+            std::cerr << e.what() << '\n';
+            std::cerr << parser;
+            exit(EXIT_FAILURE);
+        }
+    }
 }   
 
 
@@ -105,7 +133,9 @@ int main(int argc, const char* argv[]) {
     std::string input_graph_path;
     std::string input_trajectories_path;
     double tau;
+    std::vector<double> tau_values;
     double delta;
+    std::vector<double> delta_values;
     std::string output_pairwise_similarities_path;
 
     parse_command_line_arguments(
@@ -114,7 +144,9 @@ int main(int argc, const char* argv[]) {
         input_graph_path,
         input_trajectories_path,
         tau,
+        tau_values,
         delta,
+        delta_values,
         output_pairwise_similarities_path
     );
 
@@ -122,11 +154,10 @@ int main(int argc, const char* argv[]) {
     Graph social_network;
     boost::unordered_map<std::string, VertexDescriptor> string_to_vertex_descriptor_map;
     
-    std::ifstream input_file_stream(input_graph_path);
     read_adjacency_list<boost::vertex_name_t>(
         social_network,
         string_to_vertex_descriptor_map,
-        input_file_stream
+        input_graph_path
     );
 
     // load trajectory_dataset
@@ -140,6 +171,48 @@ int main(int argc, const char* argv[]) {
     // calculate and write
     std::ofstream output_file_stream { output_pairwise_similarities_path };
 
+    if (!delta_values.empty()) {
+        // find the closest matches of each pair once, and evaluate them for all (delta, tau) in delta_values x tau_values
+        const Eigen::Map<const Eigen::ArrayXd> delta_array(delta_values.data(), delta_values.size());
+        const Eigen::Map<const Eigen::ArrayXd> tau_array(tau_values.data(), tau_values.size());
+
+        output_file_stream << "first_user,second_user,delta,tau,similarity" << '\n';
+
+        for (
+            auto first_iterator = string_to_vertex_descriptor_map.cbegin();
+            first_iterator != string_to_vertex_descriptor_map.cend();
+            ++first_iterator
+        ) {
+            auto second_iterator = first_iterator;
+
+            for (
+                ++second_iterator;
+                second_iterator != string_to_vertex_descriptor_map.cend();
+                ++second_iterator
+            ) {
+                const std::string& first_user = first_iterator->first;
+                const std::string& second_user = second_iterator->first;
+                const MatchedSequences matched_sequences = calculate_matched_sequences(
+                    trajectory_dataset.at(first_user),
+                    trajectory_dataset.at(second_user)
+                );
+                const Eigen::ArrayXXd similarities = trajectory_similarities(
+                    matched_sequences,
+                    delta_array,
+                    tau_array
+                );
+
+                for (size_t delta_index = 0; delta_index < delta_values.size(); ++delta_index) {
+                    for (size_t tau_index = 0; tau_index < tau_values.size(); ++tau_index) {
+                        output_file_stream << first_user << ',' << second_user << ',' << delta_values[delta_index] << ',' << tau_values[tau_index] << ',' << similarities(delta_index, tau_index) << '\n';
+                    }
+                }
+            }
+        }
+
+        return 0;
+    }
+
     output_file_stream << "first_user,second_user,similarity" << '\n';
 
     for (
@@ -159,8 +232,8 @@ int main(int argc, const char* argv[]) {
             const double similarity = trajectory_similarity(
                 trajectory_dataset.at(first_user),
                 trajectory_dataset.at(second_user),
-                tau,
-                delta
+                delta,
+                tau
             );
 
             output_file_stream << first_user << ',' << second_user << ',' << similarity << '\n';
@@ -2,44 +2,51 @@
 // https://github.com/p-ranav/argparse
 // compile with -std=c++17
 
+#include <stdint.h>
+
+#include <algorithm>
 #include <chrono>
+#include <filesystem>
 #include <iomanip>
 #include <fstream>
-#include <memory>
+#include <stdexcept>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include <argparse/argparse.hpp>
 #include <boost/graph/adjacency_list.hpp>
-#include <boost/graph/copy.hpp>
-#include <boost/graph/filtered_graph.hpp>
 #include <boost/property_map/property_map.hpp>
 #include <boost/unordered_set.hpp>
 #include <boost/unordered_map.hpp>
 
+// csr_graph.hpp declares the Boost Graph Library functions for CSRGraph, so it precedes the algorithms calling them
+#include "csr_graph.hpp"
 #include "trajectory.h"
-#include "calculate_core_number.hpp"
+#include "calculate_core_number_in_flat_arrays.hpp"
+#include "calculate_core_number_in_parallel.hpp"
 #include "calculate_filtered_edge_set.hpp"
 #include "does_vertex_descriptor_coreness_satisfy_requirement.hpp"
+#include "dynamic_core_number.hpp"
+#include "filter_csr_graph.hpp"
 #include "is_edge_descriptor_in_edge_set.hpp"
 #include "load_trajectory_dataset.hpp"
+#include "load_trajectory_dataset_in_parallel.hpp"
+#include "parse_comma_separated_values.hpp"
 #include "profile.hpp"
-#include "read_adjacency_list.hpp"
 #include "trajectory_similarity.hpp"
+#include "trajectory_store.hpp"
 #include "write_edge_list.hpp"
 #include "write_vector.hpp"
 
 
 // Graph typedefs
-typedef boost::adjacency_list<
-    boost::vecS,
-    boost::vecS,
-    boost::undirectedS,
-    boost::property<boost::vertex_name_t, std::string>
-> Graph;
+// CSRGraph has dense edge indices, so that filtered edge sets are vectors indexed by edge index
+typedef CSRGraph Graph;
 typedef boost::graph_traits<Graph>::vertex_descriptor VertexDescriptor;
 typedef boost::graph_traits<Graph>::edge_descriptor EdgeDescriptor;
 typedef boost::graph_traits<Graph>::degree_size_type DegreeSizeType;
+typedef boost::property_map<Graph, boost::edge_index_t>::const_type EdgeIndexMap;
 
 
 void parse_command_line_arguments(
@@ -48,10 +55,14 @@ void parse_command_line_arguments(
     std::string& input_graph_path,
     std::string& input_trajectories_path,
     unsigned int& k,
+    std::vector<unsigned int>& k_values,
     unsigned int& m,
+    std::vector<unsigned int>& m_values,
     double& tau,
     double& delta,
-    std::string& output_graph_path
+    std::string& output_graph_path,
+    std::string& output_runtimes_path,
+    unsigned int& number_of_threads
 ) {
     // To start parsing command-line arguments, create an ArgumentParser
     argparse::ArgumentParser parser("");
@@ -75,15 +86,21 @@ void parse_command_line_arguments(
         );
     
     parser.add_argument("-k", "--k")
-        .required()
         .scan<'u', unsigned int>()
         .help("specify the coreness requirement for each vertex");
+    
+    // Alternatively, output communities for multiple values of k, calculating core numbers only once
+    parser.add_argument("--k-values")
+        .help("specify a comma separated list of values of k to output communities for (e.g., 3,5,7), instead of -k");
 
     parser.add_argument("-m", "--m")
-        .required()
         .scan<'u', unsigned int>()
         .help("specify the number of mutual nearest neighbors to consider for each vertex");
     
+    // Alternatively, sweep over multiple values of m, calculating trajectory similarities only once
+    parser.add_argument("--m-values")
+        .help("specify a comma separated list of values of m to sweep over (e.g., 4,6,8), instead of -m");
+    
     // Alternatively, you could provide a default value
     parser.add_argument("--delta")
         .required()
@@ -103,7 +120,15 @@ void parse_command_line_arguments(
     
     parser.add_argument("-o", "--output")
         .required()
-        .help("specify the output graph (an adjacency list)");
+        .help("specify the output graph (an adjacency list), or, with --k-values and/or --m-values, the output directory (containing one output graph for each k and/or m, e.g., <output>/<k>/<m>)");
+    
+    parser.add_argument("--runtimes-output")
+        .help("with --m-values, specify the output directory for runtimes (containing one JSON list of runtimes in microseconds for each k and/or m, each the time shared by all values of m plus the incremental time of that m)");
+    
+    parser.add_argument("--threads")
+        .default_value<unsigned int>(1)
+        .scan<'u', unsigned int>()
+        .help("the number of threads loading trajectories, calculating trajectory similarities, ranking neighbors, and calculating core numbers");
     
     // Parse arguments
     try {
@@ -119,11 +144,53 @@ void parse_command_line_arguments(
     // Use arguments
     input_graph_path = parser.get<std::string>("--graph");
     input_trajectories_path = parser.get<std::string>("--trajectories");
-    k = parser.get<unsigned int>("--k");
-    m = parser.get<unsigned int>("--m");
     tau = parser.get<double>("--tau");
     delta = parser.get<double>("--delta");
     output_graph_path = parser.get<std::string>("--output");
+    
+    // Exactly one of -k and --k-values, and exactly one of -m and --m-values, is required
+    const auto optional_k = parser.present<unsigned int>("--k");
+    const auto optional_k_values = parser.present<std::string>("--k-values");
+    const auto optional_m = parser.present<unsigned int>("--m");
+    const auto optional_m_values = parser.present<std::string>("--m-values");
+    
+    try {
+        if (optional_k && !optional_k_values) {
+            k = *optional_k;
+        }
+        else if (!optional_k && optional_k_values) {
+            k_values = parse_comma_separated_values<unsigned int>(*optional_k_values);
+            
+            if (k_values.empty()) {
+                throw std::runtime_error("--k-values: no values of k given");
+            }
+        }
+        else {
+            throw std::runtime_error("exactly one of -k and --k-values is required");
+        }
+        
+        if (optional_m && !optional_m_values) {
+            m = *optional_m;
+        }
+        else if (!optional_m && optional_m_values) {
+            m_values = parse_comma_separated_values<unsigned int>(*optional_m_values);
+            
+            if (m_values.empty()) {
+                throw std::runtime_error("--m-values: no values of m given");
+            }
+        }
+        else {
+            throw std::runtime_error("exactly one of -m and --m-values is required");
+        }
+    }
+    catch (const std::runtime_error& e) {
+        std::cerr << e.what() << '\n';
+        std::cerr << parser;
+        exit(EXIT_FAILURE);
+    }
+    
+    output_runtimes_path = parser.present<std::string>("--runtimes-output").value_or("");
+    number_of_threads = std::max(parser.get<unsigned int>("--threads"), 1u);
 }    
 
 
@@ -132,10 +199,14 @@ int main(int argc, const char* argv[]) {
     std::string input_graph_path;
     std::string input_trajectories_path;
     unsigned int k;
+    std::vector<unsigned int> k_values;
     unsigned int m;
+    std::vector<unsigned int> m_values;
     double tau;
     double delta;
     std::string output_graph_path;
+    std::string output_runtimes_path;
+    unsigned int number_of_threads;
     
     parse_command_line_arguments(
         argc,
@@ -143,103 +214,306 @@ int main(int argc, const char* argv[]) {
         input_graph_path,
         input_trajectories_path,
         k,
+        k_values,
         m,
+        m_values,
         tau,
         delta,
-        output_graph_path
+        output_graph_path,
+        output_runtimes_path,
+        number_of_threads
     );
     
     // create calculate_trajectory_similarity
     const auto calculate_trajectory_similarity = [&tau, &delta](
-        const Trajectory& first,
-        const Trajectory& second
+        const TrajectoryView& first,
+        const TrajectoryView& second
     ) {
-        return trajectory_similarity(first, second, tau, delta);
+        return trajectory_similarity(first, second, delta, tau);
     };
     
     // load social_network
-    Graph social_network;
     boost::unordered_map<std::string, VertexDescriptor> string_to_vertex_descriptor_map;
     
-    std::ifstream input_file_stream(input_graph_path);
-    read_adjacency_list<boost::vertex_name_t>(
-        social_network,
+    const Graph social_network = load_csr_graph(
         string_to_vertex_descriptor_map,
-        input_file_stream
+        input_graph_path
     );
+
+    const EdgeIndexMap edge_index_map = boost::get(boost::edge_index, social_network);
     
-    // load trajectory_dataset
-    boost::unordered_map<VertexDescriptor, Trajectory> trajectory_dataset;
-    load_trajectory_dataset(
-        string_to_vertex_descriptor_map,
-        input_trajectories_path,
-        trajectory_dataset
-    );
+    // load trajectory_dataset, storing the trajectories of all vertices contiguously (or mapping them from a trajectory file)
+    const TrajectoryStore trajectory_dataset = (number_of_threads > 1) ?
+        load_trajectory_store_in_parallel(
+            string_to_vertex_descriptor_map,
+            boost::num_vertices(social_network),
+            input_trajectories_path,
+            number_of_threads
+        ) :
+        load_trajectory_store(
+            string_to_vertex_descriptor_map,
+            boost::num_vertices(social_network),
+            input_trajectories_path
+        );
 
-    boost::unordered_set<EdgeDescriptor> filtered_edge_set;
-    IsEdgeDescriptorInEdgeSet<decltype(filtered_edge_set)> edge_predicate;
-    std::unique_ptr<boost::filtered_graph<Graph, decltype(edge_predicate)>> social_network_filtered_with_edge_predicate;
-    boost::unordered_map<VertexDescriptor, DegreeSizeType> core_number;
-    DoesVertexDescriptorCorenessSatisfyRequirement<decltype(core_number), DegreeSizeType> vertex_predicate;
-    std::unique_ptr<boost::filtered_graph<Graph, decltype(edge_predicate), decltype(vertex_predicate)>> social_network_filtered_with_edge_predicate_and_vertex_predicate;
-
-    std::vector<time_t> community_detection_runtimes_microseconds = profile<std::chrono::microseconds>(
-        [
-            &k,
-            &m,
-            &social_network,
-            &trajectory_dataset,
-            &calculate_trajectory_similarity,
-            &filtered_edge_set,
-            &edge_predicate,
-            &social_network_filtered_with_edge_predicate,
-            &core_number,
-            &vertex_predicate,
-            &social_network_filtered_with_edge_predicate_and_vertex_predicate
-        ]() {
-            filtered_edge_set = calculate_filtered_edge_set(
-                social_network,
-                trajectory_dataset,
-                calculate_trajectory_similarity,
-                m
-            );
+    // with --k-values and/or --m-values, outputs are written to <output>/<k>/<m>, <output>/<k>, or <output>/<m>
+    const bool is_sweeping_k = !k_values.empty();
+    const bool is_sweeping_m = !m_values.empty();
 
-            // create social_network_filtered_with_edge_predicate
-            edge_predicate = IsEdgeDescriptorInEdgeSet<decltype(filtered_edge_set)>(
-                &filtered_edge_set
-            );
+    if (!is_sweeping_k) {
+        k_values = { k };
+    }
 
-            social_network_filtered_with_edge_predicate = std::make_unique<boost::filtered_graph<Graph, decltype(edge_predicate)>>(
-                social_network,
-                edge_predicate
-            );
-            
-            // calculate core_number
-            core_number = calculate_core_number(*social_network_filtered_with_edge_predicate);
+    if (!is_sweeping_m) {
+        m_values = { m };
+    }
+
+    const auto get_output_path = [is_sweeping_k, is_sweeping_m](
+        std::string output_path,
+        const unsigned int k,
+        const unsigned int m
+    ) {
+        if (is_sweeping_k) {
+            output_path += '/' + std::to_string(k);
+        }
+
+        if (is_sweeping_m) {
+            output_path += '/' + std::to_string(m);
+        }
+
+        return output_path;
+    };
 
+    // creates the directories of an output path (e.g., <output>/<k>), so that the sweeps need no prepared directory tree
+    const auto create_output_directories = [](const std::string& output_path) {
+        const std::filesystem::path parent_path = std::filesystem::path(output_path).parent_path();
+
+        if (!parent_path.empty()) {
+            std::filesystem::create_directories(parent_path);
+        }
+    };
+
+    std::vector<bool> filtered_edge_set;
+    IsEdgeDescriptorInEdgeSet<decltype(filtered_edge_set), EdgeIndexMap> edge_predicate;
+    // the subgraphs are materialized, so that calculate_core_number_in_flat_arrays() and write_edge_list() do not evaluate the predicates on every visit
+    Graph social_network_filtered_with_edge_predicate;
+    std::vector<uint32_t> core_number;
+    DoesVertexDescriptorCorenessSatisfyRequirement<decltype(core_number), DegreeSizeType> vertex_predicate;
+
+    // write social_network_filtered_with_edge_predicate_and_vertex_predicate for each k, from the same core_number
+    const auto write_communities = [
+        &k_values,
+        &social_network_filtered_with_edge_predicate,
+        &core_number,
+        &vertex_predicate,
+        &get_output_path,
+        &create_output_directories,
+        &output_graph_path
+    ](const unsigned int m) {
+        for (const unsigned int k: k_values) {
             // create social_network_filtered_with_edge_predicate_and_vertex_predicate
             vertex_predicate = DoesVertexDescriptorCorenessSatisfyRequirement<decltype(core_number), DegreeSizeType>(
                 &core_number,
                 k
             );
 
-            social_network_filtered_with_edge_predicate_and_vertex_predicate = std::make_unique<boost::filtered_graph<Graph, decltype(edge_predicate), decltype(vertex_predicate)>>(
-                social_network,
-                edge_predicate,
+            const Graph social_network_filtered_with_edge_predicate_and_vertex_predicate = filter_csr_graph_vertices(
+                social_network_filtered_with_edge_predicate,
                 vertex_predicate
             );
+
+            const std::string output_path = get_output_path(output_graph_path, k, m);
+            create_output_directories(output_path);
+
+            std::ofstream output_file_stream(output_path);
+            write_edge_list<boost::vertex_name_t>(
+                social_network_filtered_with_edge_predicate_and_vertex_predicate,
+                output_file_stream
+            );
+
+            if (!output_file_stream) {
+                throw std::runtime_error("community_detection: cannot write " + output_path);
+            }
         }
-    );
+    };
 
-    // write community_detection_runtimes_microseconds
-    std::cout << community_detection_runtimes_microseconds << '\n';
+    if (!is_sweeping_m) {
+        std::vector<time_t> community_detection_runtimes_microseconds = profile<std::chrono::microseconds>(
+            [
+                &m,
+                &number_of_threads,
+                &social_network,
+                &trajectory_dataset,
+                &calculate_trajectory_similarity,
+                &filtered_edge_set,
+                &edge_index_map,
+                &edge_predicate,
+                &social_network_filtered_with_edge_predicate,
+                &core_number
+            ]() {
+                if (number_of_threads > 1) {
+                    filtered_edge_set = calculate_filtered_edge_set_in_parallel(
+                        social_network,
+                        trajectory_dataset,
+                        calculate_trajectory_similarity,
+                        m,
+                        number_of_threads
+                    );
+                }
+                else {
+                    filtered_edge_set = calculate_filtered_edge_set(
+                        social_network,
+                        trajectory_dataset,
+                        calculate_trajectory_similarity,
+                        m
+                    );
+                }
 
-    // write social_network_filtered_with_edge_predicate_and_vertex_predicate
-    std::ofstream output_file_stream(output_graph_path);
-    write_edge_list<boost::vertex_name_t>(
-        *social_network_filtered_with_edge_predicate_and_vertex_predicate,
-        output_file_stream
-    );
+                // create social_network_filtered_with_edge_predicate
+                edge_predicate = IsEdgeDescriptorInEdgeSet<decltype(filtered_edge_set), EdgeIndexMap>(
+                    &filtered_edge_set,
+                    edge_index_map
+                );
+
+                social_network_filtered_with_edge_predicate = filter_csr_graph_edges(
+                    social_network,
+                    edge_predicate
+                );
+            
+                // calculate core_number
+                core_number = (number_of_threads > 1) ?
+                    calculate_core_number_in_parallel<uint32_t>(social_network_filtered_with_edge_predicate, number_of_threads) :
+                    calculate_core_number_in_flat_arrays<uint32_t>(social_network_filtered_with_edge_predicate);
+            }
+        );
+
+        // write community_detection_runtimes_microseconds
+        std::cout << community_detection_runtimes_microseconds << '\n';
+
+        write_communities(m);
+    }
+    else {
+        // sort m_values in ascending order, so that filtered_edge_set can be grown incrementally
+        std::sort(m_values.begin(), m_values.end());
+        m_values.erase(std::unique(m_values.begin(), m_values.end()), m_values.end());
+
+        const size_t number_of_times = 8;
+        std::vector<std::vector<time_t>> community_detection_runtimes_microseconds_of_m_values(
+            m_values.size(),
+            std::vector<time_t>(number_of_times)
+        );
+
+        for (size_t repetition = 0; repetition < number_of_times; ++repetition) {
+            // calculate trajectory similarities and rank each vertex's neighbors once for all values of m
+            auto start = std::chrono::high_resolution_clock::now();
+
+            const auto edges_in_ascending_order_of_selection_threshold = (number_of_threads > 1) ?
+                calculate_edges_in_ascending_order_of_selection_threshold_in_parallel(
+                    social_network,
+                    trajectory_dataset,
+                    calculate_trajectory_similarity,
+                    number_of_threads
+                ) :
+                calculate_edges_in_ascending_order_of_selection_threshold(
+                    social_network,
+                    trajectory_dataset,
+                    calculate_trajectory_similarity
+                );
+
+            auto stop = std::chrono::high_resolution_clock::now();
+
+            const time_t shared_runtime_microseconds = std::chrono::duration_cast<std::chrono::microseconds>(stop - start).count();
+
+            filtered_edge_set.assign(boost::num_edges(social_network), false);
+            edge_predicate = IsEdgeDescriptorInEdgeSet<decltype(filtered_edge_set), EdgeIndexMap>(
+                &filtered_edge_set,
+                edge_index_map
+            );
+            auto edge_iterator = edges_in_ascending_order_of_selection_threshold.cbegin();
+
+            // core numbers are calculated from scratch for the smallest m, then updated with the edges added for each larger m,
+            // so that social_network_filtered_with_edge_predicate is only materialized to write the communities
+            DynamicCoreNumber<uint32_t> dynamic_core_number;
+            std::vector<std::pair<VertexDescriptor, VertexDescriptor>> added_edges;
+
+            for (size_t m_index = 0; m_index < m_values.size(); ++m_index) {
+                start = std::chrono::high_resolution_clock::now();
+
+                // add the edges selected for m but not for the previous values of m
+                added_edges.clear();
+
+                for (
+                    ;
+                    edge_iterator != edges_in_ascending_order_of_selection_threshold.cend() && edge_iterator->first <= m_values[m_index];
+                    ++edge_iterator
+                ) {
+                    filtered_edge_set[boost::get(edge_index_map, edge_iterator->second)] = true;
+                    added_edges.emplace_back(
+                        boost::source(edge_iterator->second, social_network),
+                        boost::target(edge_iterator->second, social_network)
+                    );
+                }
+
+                // calculate core_number
+                if (m_index > 0) {
+                    dynamic_core_number.insert_edges(added_edges);
+                }
+                else if (number_of_threads > 1) {
+                    // the parallel decomposition needs the subgraph of the smallest m, from whose core numbers only the k-order is derived
+                    const Graph social_network_filtered_with_edge_predicate_of_smallest_m = filter_csr_graph_edges(
+                        social_network,
+                        edge_predicate
+                    );
+
+                    dynamic_core_number = DynamicCoreNumber<uint32_t>(
+                        social_network_filtered_with_edge_predicate_of_smallest_m,
+                        calculate_core_number_in_parallel<uint32_t>(social_network_filtered_with_edge_predicate_of_smallest_m, number_of_threads)
+                    );
+                }
+                else {
+                    // inserting all edges into an empty graph at once recalculates the core numbers
+                    dynamic_core_number = DynamicCoreNumber<uint32_t>(boost::num_vertices(social_network));
+                    dynamic_core_number.insert_edges(added_edges);
+                }
+
+                stop = std::chrono::high_resolution_clock::now();
+
+                community_detection_runtimes_microseconds_of_m_values[m_index][repetition] = shared_runtime_microseconds + std::chrono::duration_cast<std::chrono::microseconds>(stop - start).count();
+
+                if (repetition == number_of_times - 1) {
+                    // create social_network_filtered_with_edge_predicate
+                    social_network_filtered_with_edge_predicate = filter_csr_graph_edges(
+                        social_network,
+                        edge_predicate
+                    );
+
+                    core_number = dynamic_core_number.get_core_number();
+
+                    write_communities(m_values[m_index]);
+                }
+            }
+        }
+
+        // write community_detection_runtimes_microseconds_of_m_values, where the runtime of each m is the time shared by all values of m
+        // (calculating and ranking the similarities) plus the time to add the edges of m to the previous m and update the core numbers,
+        // or to calculate them for the smallest m, so unlike the runtimes without --m-values, it does not cover filtering the graph
+        // and calculating the core numbers from scratch for m, and the runtimes of all values of m do not add up to that of the sweep
+        if (output_runtimes_path.size()) {
+            for (size_t m_index = 0; m_index < m_values.size(); ++m_index) {
+                for (const unsigned int k: k_values) {
+                    const std::string output_path = get_output_path(output_runtimes_path, k, m_values[m_index]);
+                    create_output_directories(output_path);
+
+                    std::ofstream output_file_stream(output_path);
+                    output_file_stream << community_detection_runtimes_microseconds_of_m_values[m_index] << '\n';
+
+                    if (!output_file_stream) {
+                        throw std::runtime_error("community_detection: cannot write " + output_path);
+                    }
+                }
+            }
+        }
+    }
     
     return 0;
 }
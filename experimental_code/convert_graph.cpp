@@ -0,0 +1,89 @@
+// install the following c++ package
+// https://github.com/p-ranav/argparse
+// compile with -std=c++17
+
+#include <string>
+
+#include <argparse/argparse.hpp>
+#include <boost/graph/adjacency_list.hpp>
+#include <boost/property_map/property_map.hpp>
+#include <boost/unordered_map.hpp>
+
+#include "csr_graph_file.hpp"
+#include "read_adjacency_list.hpp"
+
+
+// Graph typedefs
+typedef boost::adjacency_list<
+    boost::vecS,
+    boost::vecS,
+    boost::undirectedS,
+    boost::property<boost::vertex_name_t, std::string>
+> Graph;
+typedef boost::graph_traits<Graph>::vertex_descriptor VertexDescriptor;
+
+
+void parse_command_line_arguments(
+    int argc,
+    const char** argv,
+    std::string& input_graph_path,
+    std::string& output_path
+) {
+    // To start parsing command-line arguments, create an ArgumentParser
+    argparse::ArgumentParser parser("");
+
+    parser.add_argument("-g", "--graph")
+        .required()
+        .help("specify the input graph (an adjacency list)");
+
+    parser.add_argument("-o", "--output")
+        .required()
+        .help("specify the output CSR graph file, which all tools (and graph_distance.GraphDistance) accept in place of the adjacency list");
+
+    // Parse arguments
+    try {
+        parser.parse_args(argc, argv);
+    }
+    catch (const std::runtime_error& e) {
+        std::cerr << e.what() << '\n';
+        // std::cout << program prints a help message, including the program usage and information about the arguments registered with the ArgumentParser.
+        std::cerr << parser;
+        exit(EXIT_FAILURE);
+    }
+
+    // Use arguments
+    input_graph_path = parser.get<std::string>("--graph");
+    output_path = parser.get<std::string>("--output");
+}
+
+
+int main(int argc, const char* argv[]) {
+    // parse command line arguments
+    std::string input_graph_path;
+    std::string output_path;
+
+    parse_command_line_arguments(
+        argc,
+        argv,
+        input_graph_path,
+        output_path
+    );
+
+    // load input graph
+    Graph graph;
+    boost::unordered_map<std::string, VertexDescriptor> string_to_vertex_descriptor_map;
+
+    read_adjacency_list<boost::vertex_name_t>(
+        graph,
+        string_to_vertex_descriptor_map,
+        input_graph_path
+    );
+
+    // write CSR graph file
+    write_csr_graph_file<boost::vertex_name_t>(
+        graph,
+        output_path
+    );
+
+    return 0;
+}
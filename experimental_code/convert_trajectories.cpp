@@ -0,0 +1,116 @@
+// install the following c++ package
+// https://github.com/p-ranav/argparse
+// compile with -std=c++17
+
+#include <time.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <argparse/argparse.hpp>
+#include <boost/unordered_map.hpp>
+#include <csv.h>
+
+#include "load_trajectory_dataset_in_parallel.hpp"
+#include "trajectory.h"
+#include "trajectory_store_file.hpp"
+
+
+void parse_command_line_arguments(
+    int argc,
+    const char** argv,
+    std::string& input_trajectories_path,
+    std::string& output_path,
+    unsigned int& number_of_threads
+) {
+    // To start parsing command-line arguments, create an ArgumentParser
+    argparse::ArgumentParser parser("");
+
+    parser.add_argument("-t", "--trajectories")
+        .required()
+        .help("specify the input trajectories (a CSV file with columns user, latitude, longitude, and timestamp)");
+
+    parser.add_argument("-o", "--output")
+        .required()
+        .help("specify the output trajectory file, which all tools accept in place of the CSV file");
+
+    parser.add_argument("--threads")
+        .default_value<unsigned int>(1)
+        .scan<'u', unsigned int>()
+        .help("the number of threads parsing the input trajectories");
+
+    // Parse arguments
+    try {
+        parser.parse_args(argc, argv);
+    }
+    catch (const std::runtime_error& e) {
+        std::cerr << e.what() << '\n';
+        // std::cout << program prints a help message, including the program usage and information about the arguments registered with the ArgumentParser.
+        std::cerr << parser;
+        exit(EXIT_FAILURE);
+    }
+
+    // Use arguments
+    input_trajectories_path = parser.get<std::string>("--trajectories");
+    output_path = parser.get<std::string>("--output");
+    number_of_threads = std::max(parser.get<unsigned int>("--threads"), 1u);
+}
+
+
+int main(int argc, const char* argv[]) {
+    // parse command line arguments
+    std::string input_trajectories_path;
+    std::string output_path;
+    unsigned int number_of_threads;
+
+    parse_command_line_arguments(
+        argc,
+        argv,
+        input_trajectories_path,
+        output_path,
+        number_of_threads
+    );
+
+    // load trajectories, with users in order of first appearance and the points of each user in file order
+    std::vector<std::string> user_names;
+    std::vector<Trajectory> trajectories;
+
+    if (number_of_threads > 1) {
+        const ParsedTrajectoryDataset parsed_trajectory_dataset = parse_trajectory_dataset_in_parallel(
+            input_trajectories_path,
+            number_of_threads
+        );
+
+        user_names = parsed_trajectory_dataset.user_names;
+        for (size_t user_index = 0; user_index < user_names.size(); ++user_index) {
+            trajectories.push_back(parsed_trajectory_dataset.get_trajectory(user_index));
+        }
+    }
+    else {
+        boost::unordered_map<std::string, size_t> user_name_to_index_map;
+
+        io::CSVReader<4> in(input_trajectories_path);
+        in.read_header(io::ignore_extra_column, "user", "latitude", "longitude", "timestamp");
+
+        std::string user;
+        double latitude, longitude;
+        time_t timestamp;
+
+        while (in.read_row(user, latitude, longitude, timestamp)) {
+            const auto iterator_and_is_inserted = user_name_to_index_map.emplace(user, user_names.size());
+
+            if (iterator_and_is_inserted.second) {
+                user_names.push_back(user);
+                trajectories.emplace_back();
+            }
+
+            trajectories[iterator_and_is_inserted.first->second].push_back({latitude, longitude, timestamp});
+        }
+    }
+
+    // write trajectory file
+    write_trajectory_store_file(output_path, user_names, trajectories);
+
+    return 0;
+}
@@ -0,0 +1,432 @@
+#ifndef CSR_GRAPH_HPP
+#define CSR_GRAPH_HPP
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include <boost/graph/adjacency_list.hpp>
+#include <boost/graph/graph_traits.hpp>
+#include <boost/graph/properties.hpp>
+#include <boost/iterator/counting_iterator.hpp>
+#include <boost/iterator/iterator_facade.hpp>
+#include <boost/property_map/property_map.hpp>
+#include <boost/utility/string_view.hpp>
+
+#include "csr_graph_file.hpp"
+#include "read_adjacency_list.hpp"
+
+
+// An edge of a CSRGraph, oriented from source to target, and identified by its index.
+struct CSRGraphEdgeDescriptor {
+    uint32_t source;
+    uint32_t target;
+    uint32_t index;
+
+    bool operator==(const CSRGraphEdgeDescriptor& other) const {
+        return index == other.index;
+    }
+
+    bool operator!=(const CSRGraphEdgeDescriptor& other) const {
+        return index != other.index;
+    }
+};
+
+// Iterates the out-edges of a vertex, i.e., positions in the neighbors and edge_indices arrays of a CSRGraph.
+class CSRGraphOutEdgeIterator: public boost::iterator_facade<
+    CSRGraphOutEdgeIterator,
+    CSRGraphEdgeDescriptor,
+    boost::random_access_traversal_tag,
+    CSRGraphEdgeDescriptor
+> {
+public:
+    CSRGraphOutEdgeIterator(): source(0), neighbor(nullptr), edge_index(nullptr) { }
+
+    CSRGraphOutEdgeIterator(const uint32_t source, const uint32_t* neighbor, const uint32_t* edge_index):
+        source(source), neighbor(neighbor), edge_index(edge_index) { }
+
+private:
+    friend class boost::iterator_core_access;
+
+    uint32_t source;
+    const uint32_t* neighbor;
+    const uint32_t* edge_index;
+
+    CSRGraphEdgeDescriptor dereference() const {
+        return CSRGraphEdgeDescriptor { source, *neighbor, *edge_index };
+    }
+
+    bool equal(const CSRGraphOutEdgeIterator& other) const {
+        return neighbor == other.neighbor;
+    }
+
+    void increment() {
+        ++neighbor;
+        ++edge_index;
+    }
+
+    void decrement() {
+        --neighbor;
+        --edge_index;
+    }
+
+    void advance(const std::ptrdiff_t n) {
+        neighbor += n;
+        edge_index += n;
+    }
+
+    std::ptrdiff_t distance_to(const CSRGraphOutEdgeIterator& other) const {
+        return other.neighbor - neighbor;
+    }
+};
+
+// Iterates all edges of a CSRGraph in ascending order of edge index.
+class CSRGraphEdgeIterator: public boost::iterator_facade<
+    CSRGraphEdgeIterator,
+    CSRGraphEdgeDescriptor,
+    boost::random_access_traversal_tag,
+    CSRGraphEdgeDescriptor
+> {
+public:
+    CSRGraphEdgeIterator(): edge_sources(nullptr), edge_targets(nullptr), index(0) { }
+
+    CSRGraphEdgeIterator(const uint32_t* edge_sources, const uint32_t* edge_targets, const uint32_t index):
+        edge_sources(edge_sources), edge_targets(edge_targets), index(index) { }
+
+private:
+    friend class boost::iterator_core_access;
+
+    const uint32_t* edge_sources;
+    const uint32_t* edge_targets;
+    uint32_t index;
+
+    CSRGraphEdgeDescriptor dereference() const {
+        return CSRGraphEdgeDescriptor { edge_sources[index], edge_targets[index], index };
+    }
+
+    bool equal(const CSRGraphEdgeIterator& other) const {
+        return index == other.index;
+    }
+
+    void increment() {
+        ++index;
+    }
+
+    void decrement() {
+        --index;
+    }
+
+    void advance(const std::ptrdiff_t n) {
+        index += n;
+    }
+
+    std::ptrdiff_t distance_to(const CSRGraphEdgeIterator& other) const {
+        return static_cast<std::ptrdiff_t>(other.index) - static_cast<std::ptrdiff_t>(index);
+    }
+};
+
+struct CSRGraphTraversalCategory:
+    public virtual boost::bidirectional_graph_tag,
+    public virtual boost::adjacency_graph_tag,
+    public virtual boost::vertex_list_graph_tag,
+    public virtual boost::edge_list_graph_tag { };
+
+
+// An immutable undirected graph in compressed sparse row form, laid out as a CSR graph file (see csr_graph_file.hpp).
+// Vertices are the integers [0, number_of_vertices), which are also their vertex indices,
+// edges have dense edge indices [0, number_of_edges), and each vertex has a name (vertex_name_t).
+// It models the Boost Graph Library concepts that the tools use (VertexListGraph, EdgeListGraph, IncidenceGraph,
+// BidirectionalGraph, and AdjacencyGraph, as well as the vertex_index_t, edge_index_t, and vertex_name_t property maps),
+// so that algorithms written for a boost::adjacency_list, and boost::filtered_graph, run on it unchanged.
+// A CSRGraph made from a boost::adjacency_list with vecS storage has the same vertex descriptors, out-edge order, and edge order.
+// The arrays are either owned by the graph or point into a memory-mapped CSR graph file,
+// and storage keeps them alive for as long as any copy of the graph exists.
+struct CSRGraph {
+    // Boost Graph Library typedefs
+    typedef uint32_t vertex_descriptor;
+    typedef CSRGraphEdgeDescriptor edge_descriptor;
+    typedef boost::undirected_tag directed_category;
+    typedef boost::allow_parallel_edge_tag edge_parallel_category;
+    typedef CSRGraphTraversalCategory traversal_category;
+
+    typedef boost::counting_iterator<uint32_t> vertex_iterator;
+    typedef CSRGraphEdgeIterator edge_iterator;
+    typedef CSRGraphOutEdgeIterator out_edge_iterator;
+    typedef CSRGraphOutEdgeIterator in_edge_iterator;
+    typedef const uint32_t* adjacency_iterator;
+
+    typedef size_t vertices_size_type;
+    typedef size_t edges_size_type;
+    typedef size_t degree_size_type;
+
+    static vertex_descriptor null_vertex() {
+        return std::numeric_limits<uint32_t>::max();
+    }
+
+    size_t number_of_vertices = 0;
+    size_t number_of_edges = 0;
+    const uint64_t* name_offsets = nullptr;
+    const char* names = nullptr;
+    const uint64_t* offsets = nullptr;
+    const uint32_t* neighbors = nullptr;
+    const uint32_t* edge_indices = nullptr;
+    const uint32_t* edge_sources = nullptr;
+    const uint32_t* edge_targets = nullptr;
+    std::shared_ptr<const void> storage;
+
+    boost::string_view get_vertex_name(const vertex_descriptor vertex) const {
+        return boost::string_view(names + name_offsets[vertex], name_offsets[vertex + 1] - name_offsets[vertex]);
+    }
+};
+
+
+// a CSRGraph owning the arrays, made from a graph with vertex names in the vertex property specified with the template type PropertyTag
+template <typename PropertyTag, typename Graph> CSRGraph make_csr_graph(const Graph& graph) {
+    std::shared_ptr<CSRGraphArrays> csr_graph_arrays = std::make_shared<CSRGraphArrays>(make_csr_graph_arrays<PropertyTag>(graph));
+
+    CSRGraph csr_graph;
+    csr_graph.number_of_vertices = csr_graph_arrays->name_offsets.size() - 1;
+    csr_graph.number_of_edges = csr_graph_arrays->edge_sources.size();
+    csr_graph.name_offsets = csr_graph_arrays->name_offsets.data();
+    csr_graph.names = csr_graph_arrays->names.data();
+    csr_graph.offsets = csr_graph_arrays->offsets.data();
+    csr_graph.neighbors = csr_graph_arrays->neighbors.data();
+    csr_graph.edge_indices = csr_graph_arrays->edge_indices.data();
+    csr_graph.edge_sources = csr_graph_arrays->edge_sources.data();
+    csr_graph.edge_targets = csr_graph_arrays->edge_targets.data();
+    csr_graph.storage = std::move(csr_graph_arrays);
+
+    return csr_graph;
+}
+
+// a CSRGraph pointing into a memory-mapped CSR graph file, without copying any arrays
+// (or into a CSR graph file embedded in another file as the size bytes at offset, see CSRGraphFile)
+inline CSRGraph map_csr_graph_file(const std::string& path, const uint64_t offset = 0, const size_t size = 0) {
+    std::shared_ptr<const CSRGraphFile> csr_graph_file = std::make_shared<const CSRGraphFile>(path, offset, size);
+
+    CSRGraph csr_graph;
+    csr_graph.number_of_vertices = csr_graph_file->number_of_vertices;
+    csr_graph.number_of_edges = csr_graph_file->number_of_edges;
+    csr_graph.name_offsets = csr_graph_file->name_offsets;
+    csr_graph.names = csr_graph_file->names;
+    csr_graph.offsets = csr_graph_file->offsets;
+    csr_graph.neighbors = csr_graph_file->neighbors;
+    csr_graph.edge_indices = csr_graph_file->edge_indices;
+    csr_graph.edge_sources = csr_graph_file->edge_sources;
+    csr_graph.edge_targets = csr_graph_file->edge_targets;
+    csr_graph.storage = std::move(csr_graph_file);
+
+    return csr_graph;
+}
+
+// write a CSRGraph, owning its arrays or not, as a CSR graph file at the current position of output_stream,
+// which map_csr_graph_file() maps back with the same vertex descriptors and edge order
+inline void write_csr_graph_file(const CSRGraph& graph, std::ostream& output_stream) {
+    write_csr_graph_file(
+        output_stream,
+        graph.number_of_vertices,
+        graph.number_of_edges,
+        graph.name_offsets,
+        graph.names,
+        graph.offsets,
+        graph.neighbors,
+        graph.edge_indices,
+        graph.edge_sources,
+        graph.edge_targets
+    );
+}
+
+// Loads a CSR graph file or an adjacency list (see read_adjacency_list.hpp) into a CSRGraph, and maps each vertex name to its vertex.
+// A CSR graph file is mapped, and an adjacency list is read into a boost::adjacency_list first,
+// so either way, the vertices and edges are in the same order as when reading the file with read_adjacency_list().
+template <typename StringToVertexDescriptorMap> CSRGraph load_csr_graph(
+    StringToVertexDescriptorMap& string_to_vertex_descriptor_map,
+    const std::string& input_path
+) {
+    CSRGraph csr_graph;
+
+    if (is_csr_graph_file(input_path)) {
+        csr_graph = map_csr_graph_file(input_path);
+    }
+    else {
+        typedef boost::adjacency_list<
+            boost::vecS,
+            boost::vecS,
+            boost::undirectedS,
+            boost::property<boost::vertex_name_t, std::string>
+        > AdjacencyList;
+
+        AdjacencyList adjacency_list;
+        read_adjacency_list<boost::vertex_name_t>(adjacency_list, input_path);
+
+        csr_graph = make_csr_graph<boost::vertex_name_t>(adjacency_list);
+    }
+
+    string_to_vertex_descriptor_map.reserve(string_to_vertex_descriptor_map.size() + csr_graph.number_of_vertices);
+    for (uint32_t vertex = 0; vertex < csr_graph.number_of_vertices; ++vertex) {
+        const boost::string_view name = csr_graph.get_vertex_name(vertex);
+        string_to_vertex_descriptor_map[std::string(name.data(), name.size())] = vertex;
+    }
+
+    return csr_graph;
+}
+
+
+// Reads the edge index of an edge of a CSRGraph.
+struct CSRGraphEdgeIndexMap: public boost::put_get_helper<size_t, CSRGraphEdgeIndexMap> {
+    typedef CSRGraphEdgeDescriptor key_type;
+    typedef size_t value_type;
+    typedef size_t reference;
+    typedef boost::readable_property_map_tag category;
+
+    size_t operator[](const CSRGraphEdgeDescriptor& edge_descriptor) const {
+        return edge_descriptor.index;
+    }
+};
+
+// Reads the name of a vertex of a CSRGraph, as a view into the graph's name table.
+struct CSRGraphVertexNameMap: public boost::put_get_helper<boost::string_view, CSRGraphVertexNameMap> {
+    typedef uint32_t key_type;
+    typedef boost::string_view value_type;
+    typedef boost::string_view reference;
+    typedef boost::readable_property_map_tag category;
+
+    const CSRGraph* graph;
+
+    CSRGraphVertexNameMap(): graph(nullptr) { }
+
+    explicit CSRGraphVertexNameMap(const CSRGraph* graph): graph(graph) { }
+
+    boost::string_view operator[](const uint32_t vertex) const {
+        return graph->get_vertex_name(vertex);
+    }
+};
+
+
+// The Boost Graph Library functions for CSRGraph are found by argument-dependent lookup in the global namespace
+// when called unqualified, as in Boost's own algorithms and boost::filtered_graph,
+// and are also declared in namespace boost for the tools, which call them qualified (e.g., boost::out_edges()).
+// As the qualified calls are looked up where a template is defined, this header precedes the algorithms calling them.
+
+inline std::pair<CSRGraph::vertex_iterator, CSRGraph::vertex_iterator> vertices(const CSRGraph& graph) {
+    return std::make_pair(
+        CSRGraph::vertex_iterator(0),
+        CSRGraph::vertex_iterator(static_cast<uint32_t>(graph.number_of_vertices))
+    );
+}
+
+inline size_t num_vertices(const CSRGraph& graph) {
+    return graph.number_of_vertices;
+}
+
+inline std::pair<CSRGraph::edge_iterator, CSRGraph::edge_iterator> edges(const CSRGraph& graph) {
+    return std::make_pair(
+        CSRGraph::edge_iterator(graph.edge_sources, graph.edge_targets, 0),
+        CSRGraph::edge_iterator(graph.edge_sources, graph.edge_targets, static_cast<uint32_t>(graph.number_of_edges))
+    );
+}
+
+inline size_t num_edges(const CSRGraph& graph) {
+    return graph.number_of_edges;
+}
+
+inline uint32_t source(const CSRGraphEdgeDescriptor& edge_descriptor, const CSRGraph&) {
+    return edge_descriptor.source;
+}
+
+inline uint32_t target(const CSRGraphEdgeDescriptor& edge_descriptor, const CSRGraph&) {
+    return edge_descriptor.target;
+}
+
+inline std::pair<CSRGraph::out_edge_iterator, CSRGraph::out_edge_iterator> out_edges(const uint32_t vertex, const CSRGraph& graph) {
+    return std::make_pair(
+        CSRGraph::out_edge_iterator(vertex, graph.neighbors + graph.offsets[vertex], graph.edge_indices + graph.offsets[vertex]),
+        CSRGraph::out_edge_iterator(vertex, graph.neighbors + graph.offsets[vertex + 1], graph.edge_indices + graph.offsets[vertex + 1])
+    );
+}
+
+inline size_t out_degree(const uint32_t vertex, const CSRGraph& graph) {
+    return graph.offsets[vertex + 1] - graph.offsets[vertex];
+}
+
+// the graph is undirected, so in-edges are out-edges
+inline std::pair<CSRGraph::in_edge_iterator, CSRGraph::in_edge_iterator> in_edges(const uint32_t vertex, const CSRGraph& graph) {
+    return out_edges(vertex, graph);
+}
+
+inline size_t in_degree(const uint32_t vertex, const CSRGraph& graph) {
+    return out_degree(vertex, graph);
+}
+
+inline size_t degree(const uint32_t vertex, const CSRGraph& graph) {
+    return out_degree(vertex, graph);
+}
+
+inline std::pair<CSRGraph::adjacency_iterator, CSRGraph::adjacency_iterator> adjacent_vertices(const uint32_t vertex, const CSRGraph& graph) {
+    return std::make_pair(
+        graph.neighbors + graph.offsets[vertex],
+        graph.neighbors + graph.offsets[vertex + 1]
+    );
+}
+
+inline boost::typed_identity_property_map<uint32_t> get(boost::vertex_index_t, const CSRGraph&) {
+    return boost::typed_identity_property_map<uint32_t>();
+}
+
+inline uint32_t get(boost::vertex_index_t, const CSRGraph&, const uint32_t vertex) {
+    return vertex;
+}
+
+inline CSRGraphEdgeIndexMap get(boost::edge_index_t, const CSRGraph&) {
+    return CSRGraphEdgeIndexMap();
+}
+
+inline size_t get(boost::edge_index_t, const CSRGraph&, const CSRGraphEdgeDescriptor& edge_descriptor) {
+    return edge_descriptor.index;
+}
+
+inline CSRGraphVertexNameMap get(boost::vertex_name_t, const CSRGraph& graph) {
+    return CSRGraphVertexNameMap(&graph);
+}
+
+inline boost::string_view get(boost::vertex_name_t, const CSRGraph& graph, const uint32_t vertex) {
+    return graph.get_vertex_name(vertex);
+}
+
+namespace boost {
+    template <> struct property_map<CSRGraph, vertex_index_t> {
+        typedef typed_identity_property_map<uint32_t> type;
+        typedef type const_type;
+    };
+
+    template <> struct property_map<CSRGraph, edge_index_t> {
+        typedef CSRGraphEdgeIndexMap type;
+        typedef type const_type;
+    };
+
+    template <> struct property_map<CSRGraph, vertex_name_t> {
+        typedef CSRGraphVertexNameMap type;
+        typedef type const_type;
+    };
+
+    using ::vertices;
+    using ::num_vertices;
+    using ::edges;
+    using ::num_edges;
+    using ::source;
+    using ::target;
+    using ::out_edges;
+    using ::out_degree;
+    using ::in_edges;
+    using ::in_degree;
+    using ::degree;
+    using ::adjacent_vertices;
+    using ::get;
+}
+
+#endif
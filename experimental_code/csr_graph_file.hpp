@@ -0,0 +1,369 @@
+#ifndef CSR_GRAPH_FILE_HPP
+#define CSR_GRAPH_FILE_HPP
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <boost/graph/graph_traits.hpp>
+#include <boost/graph/properties.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/property_map/property_map.hpp>
+#include <boost/utility/string_view.hpp>
+
+
+// A binary undirected graph file in compressed sparse row (CSR) form, in native byte order, laid out as
+//
+//     CSRGraphFileHeader
+//     uint64_t name_offsets[number_of_vertices + 1]    vertex i is named names[name_offsets[i], name_offsets[i + 1])
+//     uint64_t offsets[number_of_vertices + 1]         vertex i has the out-edges [offsets[i], offsets[i + 1])
+//     char names[names_size]                           padded with zeros to a multiple of 8 bytes
+//     uint32_t neighbors[2 * number_of_edges]          the target of each out-edge
+//     uint32_t edge_indices[2 * number_of_edges]       the index of the edge of each out-edge
+//     uint32_t edge_sources[number_of_edges]           the source of each edge, by edge index
+//     uint32_t edge_targets[number_of_edges]           the target of each edge, by edge index
+//
+// Edges are numbered in the order they were added to the graph, and the out-edges of each vertex are in ascending order of edge index,
+// which is the order of boost::edges() and boost::out_edges() for a boost::adjacency_list with vecS storage,
+// so that such a graph can be rebuilt with the same vertex descriptors, edge order, and edge orientations.
+// A self-loop is an out-edge of its vertex twice, as in a boost::adjacency_list.
+
+const char CSR_GRAPH_FILE_MAGIC[8] = { 'C', 'S', 'R', 'G', 'R', 'A', 'P', 'H' };
+const uint64_t CSR_GRAPH_FILE_VERSION = 1;
+
+struct CSRGraphFileHeader {
+    char magic[8];
+    uint64_t version;
+    uint64_t number_of_vertices;
+    uint64_t number_of_edges;
+    uint64_t names_size;
+};
+
+
+// whether the file at path starts with CSR_GRAPH_FILE_MAGIC, as opposed to, e.g., an adjacency list
+inline bool is_csr_graph_file(const std::string& path) {
+    std::ifstream input_file_stream(path, std::ios::binary);
+
+    char magic[sizeof(CSR_GRAPH_FILE_MAGIC)];
+    if (!input_file_stream.read(magic, sizeof(magic))) return false;
+
+    return memcmp(magic, CSR_GRAPH_FILE_MAGIC, sizeof(magic)) == 0;
+}
+
+
+// The arrays of a CSR graph file, built in memory (names are not padded)
+struct CSRGraphArrays {
+    std::vector<uint64_t> name_offsets;
+    std::vector<char> names;
+    std::vector<uint64_t> offsets;
+    std::vector<uint32_t> neighbors;
+    std::vector<uint32_t> edge_indices;
+    std::vector<uint32_t> edge_sources;
+    std::vector<uint32_t> edge_targets;
+};
+
+// build the arrays of a graph with vertex names in the vertex property specified with the template type PropertyTag,
+// numbering vertices by vertex index and edges in the order of boost::edges()
+template <typename PropertyTag, typename Graph> CSRGraphArrays make_csr_graph_arrays(const Graph& graph) {
+    const auto vertex_index_map = boost::get(boost::vertex_index, graph);
+
+    const size_t number_of_vertices = boost::num_vertices(graph);
+    const size_t number_of_edges = boost::num_edges(graph);
+
+    if (
+        number_of_vertices > std::numeric_limits<uint32_t>::max()
+        || 2 * number_of_edges > std::numeric_limits<uint32_t>::max()
+    ) {
+        throw std::runtime_error("make_csr_graph_arrays: the graph is too large for 32-bit vertex and edge indices");
+    }
+
+    CSRGraphArrays csr_graph_arrays;
+
+    // names, by vertex index
+    std::vector<std::string> names_by_vertex_index(number_of_vertices);
+
+    typename boost::graph_traits<Graph>::vertex_iterator vertex_iterator, vertex_end;
+    for (std::tie(vertex_iterator, vertex_end) = boost::vertices(graph); vertex_iterator != vertex_end; ++vertex_iterator) {
+        const auto& name = boost::get(PropertyTag(), graph, *vertex_iterator);
+        names_by_vertex_index[boost::get(vertex_index_map, *vertex_iterator)].assign(name.data(), name.size());
+    }
+
+    csr_graph_arrays.name_offsets.assign(number_of_vertices + 1, 0);
+    for (size_t vertex = 0; vertex < number_of_vertices; ++vertex) {
+        csr_graph_arrays.name_offsets[vertex + 1] = csr_graph_arrays.name_offsets[vertex] + names_by_vertex_index[vertex].size();
+    }
+
+    csr_graph_arrays.names.reserve(csr_graph_arrays.name_offsets[number_of_vertices]);
+    for (const std::string& name: names_by_vertex_index) {
+        csr_graph_arrays.names.insert(csr_graph_arrays.names.end(), name.begin(), name.end());
+    }
+
+    // edge list, by edge index
+    csr_graph_arrays.edge_sources.reserve(number_of_edges);
+    csr_graph_arrays.edge_targets.reserve(number_of_edges);
+
+    typename boost::graph_traits<Graph>::edge_iterator edge_iterator, edge_end;
+    for (std::tie(edge_iterator, edge_end) = boost::edges(graph); edge_iterator != edge_end; ++edge_iterator) {
+        csr_graph_arrays.edge_sources.push_back(boost::get(vertex_index_map, boost::source(*edge_iterator, graph)));
+        csr_graph_arrays.edge_targets.push_back(boost::get(vertex_index_map, boost::target(*edge_iterator, graph)));
+    }
+
+    const std::vector<uint32_t>& edge_sources = csr_graph_arrays.edge_sources;
+    const std::vector<uint32_t>& edge_targets = csr_graph_arrays.edge_targets;
+
+    // out-edges, bucketed by source with a counting sort that keeps them in ascending order of edge index
+    std::vector<uint64_t>& offsets = csr_graph_arrays.offsets;
+    offsets.assign(number_of_vertices + 1, 0);
+    for (size_t edge = 0; edge < number_of_edges; ++edge) {
+        ++offsets[edge_sources[edge] + 1];
+        ++offsets[edge_targets[edge] + 1];
+    }
+    for (size_t vertex = 0; vertex < number_of_vertices; ++vertex) {
+        offsets[vertex + 1] += offsets[vertex];
+    }
+
+    std::vector<uint32_t>& neighbors = csr_graph_arrays.neighbors;
+    std::vector<uint32_t>& edge_indices = csr_graph_arrays.edge_indices;
+    neighbors.resize(2 * number_of_edges);
+    edge_indices.resize(2 * number_of_edges);
+
+    std::vector<uint64_t> positions(offsets.begin(), offsets.end() - 1);
+    for (size_t edge = 0; edge < number_of_edges; ++edge) {
+        const uint64_t source_position = positions[edge_sources[edge]]++;
+        neighbors[source_position] = edge_targets[edge];
+        edge_indices[source_position] = edge;
+
+        const uint64_t target_position = positions[edge_targets[edge]]++;
+        neighbors[target_position] = edge_sources[edge];
+        edge_indices[target_position] = edge;
+    }
+
+    return csr_graph_arrays;
+}
+
+
+template <typename T> void write_csr_graph_file_array(std::ostream& output_stream, const T* array, const size_t size) {
+    output_stream.write(
+        reinterpret_cast<const char*>(array),
+        size * sizeof(T)
+    );
+}
+
+// write the arrays of a CSR graph, whose names are not padded, as a CSR graph file at the current position of output_stream
+// (e.g., to embed one in another file, which can be mapped with CSRGraphFile at that offset)
+inline void write_csr_graph_file(
+    std::ostream& output_stream,
+    const size_t number_of_vertices,
+    const size_t number_of_edges,
+    const uint64_t* name_offsets,
+    const char* names,
+    const uint64_t* offsets,
+    const uint32_t* neighbors,
+    const uint32_t* edge_indices,
+    const uint32_t* edge_sources,
+    const uint32_t* edge_targets
+) {
+    CSRGraphFileHeader header;
+    memcpy(header.magic, CSR_GRAPH_FILE_MAGIC, sizeof(header.magic));
+    header.version = CSR_GRAPH_FILE_VERSION;
+    header.number_of_vertices = number_of_vertices;
+    header.number_of_edges = number_of_edges;
+    header.names_size = (name_offsets[number_of_vertices] + 7) / 8 * 8;
+
+    const std::vector<char> padding(header.names_size - name_offsets[number_of_vertices], 0);
+
+    output_stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    write_csr_graph_file_array(output_stream, name_offsets, number_of_vertices + 1);
+    write_csr_graph_file_array(output_stream, offsets, number_of_vertices + 1);
+    write_csr_graph_file_array(output_stream, names, name_offsets[number_of_vertices]);
+    write_csr_graph_file_array(output_stream, padding.data(), padding.size());
+    write_csr_graph_file_array(output_stream, neighbors, 2 * number_of_edges);
+    write_csr_graph_file_array(output_stream, edge_indices, 2 * number_of_edges);
+    write_csr_graph_file_array(output_stream, edge_sources, number_of_edges);
+    write_csr_graph_file_array(output_stream, edge_targets, number_of_edges);
+}
+
+inline void write_csr_graph_file(
+    const CSRGraphArrays& csr_graph_arrays,
+    const std::string& path
+) {
+    std::ofstream output_file_stream(path, std::ios::binary);
+
+    write_csr_graph_file(
+        output_file_stream,
+        csr_graph_arrays.name_offsets.size() - 1,
+        csr_graph_arrays.edge_sources.size(),
+        csr_graph_arrays.name_offsets.data(),
+        csr_graph_arrays.names.data(),
+        csr_graph_arrays.offsets.data(),
+        csr_graph_arrays.neighbors.data(),
+        csr_graph_arrays.edge_indices.data(),
+        csr_graph_arrays.edge_sources.data(),
+        csr_graph_arrays.edge_targets.data()
+    );
+
+    if (!output_file_stream) {
+        throw std::runtime_error("write_csr_graph_file: cannot write " + path);
+    }
+}
+
+// write a graph with vertex names in the vertex property specified with the template type PropertyTag to a CSR graph file
+template <typename PropertyTag, typename Graph> void write_csr_graph_file(
+    const Graph& graph,
+    const std::string& path
+) {
+    write_csr_graph_file(make_csr_graph_arrays<PropertyTag>(graph), path);
+}
+
+
+// A CSR graph file mapped into memory read-only, with pointers to its arrays.
+// The CSR graph file may also be embedded in another file, as the size bytes at offset (size 0 maps the rest of the file).
+struct CSRGraphFile {
+    boost::interprocess::file_mapping file_mapping;
+    boost::interprocess::mapped_region mapped_region;
+
+    size_t number_of_vertices;
+    size_t number_of_edges;
+    const uint64_t* name_offsets;
+    const uint64_t* offsets;
+    const char* names;
+    const uint32_t* neighbors;
+    const uint32_t* edge_indices;
+    const uint32_t* edge_sources;
+    const uint32_t* edge_targets;
+
+    // throws std::runtime_error if the file is not a CSR graph file or is truncated
+    explicit CSRGraphFile(const std::string& path, const uint64_t offset = 0, const size_t size = 0):
+        file_mapping(path.c_str(), boost::interprocess::read_only),
+        mapped_region(file_mapping, boost::interprocess::read_only, offset, size) {
+        const char* begin = static_cast<const char*>(mapped_region.get_address());
+        const size_t mapped_size = mapped_region.get_size();
+
+        CSRGraphFileHeader header;
+        if (mapped_size < sizeof(header)) {
+            throw std::runtime_error("CSRGraphFile: " + path + " is too small to be a CSR graph file");
+        }
+        memcpy(&header, begin, sizeof(header));
+
+        if (memcmp(header.magic, CSR_GRAPH_FILE_MAGIC, sizeof(header.magic)) != 0) {
+            throw std::runtime_error("CSRGraphFile: " + path + " is not a CSR graph file");
+        }
+        if (header.version != CSR_GRAPH_FILE_VERSION) {
+            throw std::runtime_error("CSRGraphFile: " + path + " has unsupported version " + std::to_string(header.version));
+        }
+
+        number_of_vertices = header.number_of_vertices;
+        number_of_edges = header.number_of_edges;
+
+        // bound the counts by the mapped size before multiplying them, so that a corrupt header cannot overflow expected_size
+        if (
+            number_of_vertices >= mapped_size / (2 * sizeof(uint64_t))
+            || header.names_size > mapped_size
+            || number_of_edges > mapped_size / (6 * sizeof(uint32_t))
+        ) {
+            throw std::runtime_error("CSRGraphFile: " + path + " has a header with more vertices, names, or edges than fit in it");
+        }
+
+        const size_t expected_size = sizeof(header)
+            + 2 * (number_of_vertices + 1) * sizeof(uint64_t)
+            + header.names_size
+            + 6 * number_of_edges * sizeof(uint32_t);
+        if (mapped_size != expected_size) {
+            throw std::runtime_error("CSRGraphFile: " + path + " has " + std::to_string(mapped_size) + " bytes instead of " + std::to_string(expected_size));
+        }
+
+        const char* position = begin + sizeof(header);
+        name_offsets = reinterpret_cast<const uint64_t*>(position);
+        position += (number_of_vertices + 1) * sizeof(uint64_t);
+        offsets = reinterpret_cast<const uint64_t*>(position);
+        position += (number_of_vertices + 1) * sizeof(uint64_t);
+        names = position;
+        position += header.names_size;
+        neighbors = reinterpret_cast<const uint32_t*>(position);
+        position += 2 * number_of_edges * sizeof(uint32_t);
+        edge_indices = reinterpret_cast<const uint32_t*>(position);
+        position += 2 * number_of_edges * sizeof(uint32_t);
+        edge_sources = reinterpret_cast<const uint32_t*>(position);
+        position += number_of_edges * sizeof(uint32_t);
+        edge_targets = reinterpret_cast<const uint32_t*>(position);
+
+        // the offsets must ascend from 0 to the end of names and neighbors, so that every vertex's range lies within them
+        bool is_consistent = name_offsets[0] == 0 && offsets[0] == 0
+            && name_offsets[number_of_vertices] <= header.names_size && offsets[number_of_vertices] == 2 * number_of_edges;
+        for (size_t vertex = 0; is_consistent && vertex < number_of_vertices; ++vertex) {
+            is_consistent = name_offsets[vertex] <= name_offsets[vertex + 1] && offsets[vertex] <= offsets[vertex + 1];
+        }
+
+        if (!is_consistent) {
+            throw std::runtime_error("CSRGraphFile: " + path + " has inconsistent offsets");
+        }
+
+        // every out-edge and edge must refer to an existing vertex and edge, so that readers can index by them unchecked
+        bool is_in_range = true;
+        for (size_t position = 0; is_in_range && position < 2 * number_of_edges; ++position) {
+            is_in_range = neighbors[position] < number_of_vertices && edge_indices[position] < number_of_edges;
+        }
+        for (size_t edge = 0; is_in_range && edge < number_of_edges; ++edge) {
+            is_in_range = edge_sources[edge] < number_of_vertices && edge_targets[edge] < number_of_vertices;
+        }
+
+        if (!is_in_range) {
+            throw std::runtime_error("CSRGraphFile: " + path + " has vertex or edge indices out of range");
+        }
+    }
+
+    boost::string_view get_vertex_name(const size_t vertex) const {
+        return boost::string_view(names + name_offsets[vertex], name_offsets[vertex + 1] - name_offsets[vertex]);
+    }
+};
+
+
+// Reads a CSR graph file into a boost::graph object, like read_adjacency_list() does an adjacency list.
+// Stores vertex names as std::string objects in the vertex property specified with the template type PropertyTag.
+// Vertices are added in order of vertex index and edges in order of edge index, so a boost::adjacency_list written with
+// write_csr_graph_file() is read back with the same vertex descriptors and edge order.
+template <typename PropertyTag, typename Graph, typename StringToVertexDescriptorMap> void read_csr_graph_file(
+    Graph& graph,
+    StringToVertexDescriptorMap& string_to_vertex_descriptor_map,
+    const std::string& input_path
+) {
+    const CSRGraphFile csr_graph_file(input_path);
+
+    typename boost::property_map<Graph, PropertyTag>::type property_map = boost::get(
+        PropertyTag(),
+        graph
+    );
+
+    std::vector<typename boost::graph_traits<Graph>::vertex_descriptor> vertex_descriptors;
+    vertex_descriptors.reserve(csr_graph_file.number_of_vertices);
+    string_to_vertex_descriptor_map.reserve(string_to_vertex_descriptor_map.size() + csr_graph_file.number_of_vertices);
+
+    for (size_t vertex = 0; vertex < csr_graph_file.number_of_vertices; ++vertex) {
+        const boost::string_view name_view = csr_graph_file.get_vertex_name(vertex);
+        const std::string name(name_view.data(), name_view.size());
+
+        const typename boost::graph_traits<Graph>::vertex_descriptor vertex_descriptor = boost::add_vertex(graph);
+        boost::put(property_map, vertex_descriptor, name);
+        string_to_vertex_descriptor_map[name] = vertex_descriptor;
+
+        vertex_descriptors.push_back(vertex_descriptor);
+    }
+
+    for (size_t edge = 0; edge < csr_graph_file.number_of_edges; ++edge) {
+        boost::add_edge(
+            vertex_descriptors[csr_graph_file.edge_sources[edge]],
+            vertex_descriptors[csr_graph_file.edge_targets[edge]],
+            graph
+        );
+    }
+}
+
+#endif
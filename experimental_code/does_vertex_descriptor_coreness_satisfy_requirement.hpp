@@ -1,6 +1,8 @@
 #ifndef DOES_VERTEX_DESCRIPTOR_CORENESS_SATISFY_REQUIREMENT_HPP
 #define DOES_VERTEX_DESCRIPTOR_CORENESS_SATISFY_REQUIREMENT_HPP
 
+// VertexDescriptorToCorenessMap is indexed by vertex descriptor (e.g., the std::vector returned by calculate_core_number() for a vecS graph),
+// so that each lookup is an array load rather than a hash lookup.
 template <typename VertexDescriptorToCorenessMap, typename DegreeSizeType> struct DoesVertexDescriptorCorenessSatisfyRequirement {
     VertexDescriptorToCorenessMap* vertex_descriptor_to_coreness_map_pointer;
     DegreeSizeType vertex_descriptor_coreness_requirement;
@@ -17,7 +19,7 @@ template <typename VertexDescriptorToCorenessMap, typename DegreeSizeType> struc
         vertex_descriptor_coreness_requirement(t_vertex_descriptor_coreness_requirement) { }
     
     template <typename VertexDescriptor> bool operator()(const VertexDescriptor& vertex_descriptor) const {
-        return vertex_descriptor_to_coreness_map_pointer->at(vertex_descriptor) >= vertex_descriptor_coreness_requirement;
+        return (*vertex_descriptor_to_coreness_map_pointer)[vertex_descriptor] >= vertex_descriptor_coreness_requirement;
     }
 };
 
@@ -0,0 +1,666 @@
+#ifndef DYNAMIC_CORE_NUMBER_HPP
+#define DYNAMIC_CORE_NUMBER_HPP
+
+/**
+ * https://doi.org/10.1109/ICDE.2017.92 (Zhang et al., a fast order-based approach for core maintenance)
+ * https://doi.org/10.1007/s00778-016-0423-8 (Sariyuce et al., incremental k-core decomposition)
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <boost/graph/graph_traits.hpp>
+#include <boost/graph/properties.hpp>
+
+// declares the graph functions in namespace boost, for both CSRGraph and the adjacency lists of boost/graph/adjacency_list.hpp,
+// before the constructor from a graph calls them qualified
+#include "csr_graph.hpp"
+
+
+// The core numbers of a graph with a fixed set of vertices [0, number_of_vertices) under batches of edge insertions and deletions,
+// updated with the order-based algorithms of Zhang et al. instead of a new core decomposition after each batch.
+// They maintain a k-order: the vertices in ascending order of core number, in which each vertex has at most its core number
+// of neighbors after it (out_degrees), as in a removal order of the Batagelj and Zaversnik algorithm.
+// An insertion only visits the vertices after the earlier endpoint, with the same core number, adjacent to a candidate for promotion,
+// and a deletion only the vertices whose core number decreases and their neighbors, so an update costs time proportional to
+// the neighborhood of the changed vertices rather than to the graph.
+// A batch with more than number_of_edges / recalculation_divisor edges is applied by recalculating the core numbers and k-order
+// from scratch instead, which is then faster than updating them edge by edge.
+// The graph may have parallel edges, which count toward degrees as in boost::degree(), but no self-loops.
+template <typename Index> struct DynamicCoreNumber {
+    std::vector<std::vector<Index>> adjacent_vertices;
+    size_t number_of_edges = 0;
+    std::vector<Index> core_number;
+    std::vector<Index> out_degrees;
+
+    // the vertices with core number k form a doubly linked list from heads[k] to tails[k] in the k-order,
+    // where labels increase along each list, so that two vertices are compared in constant time
+    std::vector<Index> next_vertices;
+    std::vector<Index> previous_vertices;
+    std::vector<uint64_t> labels;
+    std::vector<Index> heads;
+    std::vector<Index> tails;
+
+    static constexpr Index null_vertex = std::numeric_limits<Index>::max();
+    // recalculating costs about as much as inserting 2% of the edges one at a time on the Brightkite and Gowalla social networks
+    static constexpr size_t recalculation_divisor = 50;
+
+    DynamicCoreNumber() = default;
+
+    // an empty graph, with every core number 0
+    explicit DynamicCoreNumber(const size_t number_of_vertices):
+        adjacent_vertices(number_of_vertices),
+        core_number(number_of_vertices, 0),
+        out_degrees(number_of_vertices, 0),
+        next_vertices(number_of_vertices, null_vertex),
+        previous_vertices(number_of_vertices, null_vertex),
+        labels(number_of_vertices, 0),
+        heads(1, null_vertex),
+        tails(1, null_vertex),
+        counts(number_of_vertices, 0),
+        extra_out_degrees(number_of_vertices, 0),
+        states(number_of_vertices, unvisited)
+    {
+        if (number_of_vertices >= null_vertex) {
+            throw std::overflow_error("DynamicCoreNumber: too many vertices for the index type");
+        }
+
+        std::vector<Index> order(number_of_vertices);
+        for (size_t vertex = 0; vertex < number_of_vertices; ++vertex) {
+            order[vertex] = vertex;
+        }
+
+        link_in_order(order);
+    }
+
+    // a copy of graph, whose vertex descriptors are their vertex indices in [0, num_vertices(graph)), all of which are vertices of graph
+    // (e.g., CSRGraph)
+    template <
+        typename Graph,
+        typename = typename std::enable_if<!std::is_integral<Graph>::value>::type
+    > explicit DynamicCoreNumber(
+        const Graph& graph
+    ): DynamicCoreNumber(boost::num_vertices(graph)) {
+        copy_adjacent_vertices(graph);
+        recalculate();
+    }
+
+    // a copy of graph as above, with its core numbers already calculated (e.g., by calculate_core_number_in_parallel()),
+    // from which only the k-order is derived
+    template <typename Graph> DynamicCoreNumber(
+        const Graph& graph,
+        const std::vector<Index>& graph_core_number
+    ): DynamicCoreNumber(boost::num_vertices(graph)) {
+        if (graph_core_number.size() != core_number.size()) {
+            throw std::invalid_argument("DynamicCoreNumber: the core numbers are not those of the graph's vertices");
+        }
+
+        copy_adjacent_vertices(graph);
+        core_number = graph_core_number;
+        order_by_core_number();
+    }
+
+    const std::vector<Index>& get_core_number() const {
+        return core_number;
+    }
+
+    // inserts a batch of edges (pairs of vertex indices), e.g., the edges selected for the next value of m
+    template <typename Edges> void insert_edges(const Edges& edges) {
+        if (edges.size() * recalculation_divisor > number_of_edges) {
+            for (const auto& edge: edges) {
+                adjacent_vertices[edge.first].push_back(edge.second);
+                adjacent_vertices[edge.second].push_back(edge.first);
+            }
+
+            number_of_edges += edges.size();
+            recalculate();
+        }
+        else {
+            for (const auto& edge: edges) {
+                insert_edge(edge.first, edge.second);
+            }
+        }
+    }
+
+    // removes a batch of edges, each of which must be in the graph
+    template <typename Edges> void remove_edges(const Edges& edges) {
+        if (edges.size() * recalculation_divisor > number_of_edges) {
+            for (const auto& edge: edges) {
+                remove_adjacent_vertex(edge.first, edge.second);
+                remove_adjacent_vertex(edge.second, edge.first);
+            }
+
+            number_of_edges -= edges.size();
+            recalculate();
+        }
+        else {
+            for (const auto& edge: edges) {
+                remove_edge(edge.first, edge.second);
+            }
+        }
+    }
+
+    // Batagelj and Zaversnik's algorithm on adjacent_vertices, as in calculate_core_number_in_flat_arrays(),
+    // whose removal order becomes the k-order
+    void recalculate() {
+        const size_t number_of_vertices = adjacent_vertices.size();
+
+        Index max_degree = 0;
+        for (size_t vertex = 0; vertex < number_of_vertices; ++vertex) {
+            if (adjacent_vertices[vertex].size() >= null_vertex) {
+                throw std::overflow_error("DynamicCoreNumber: a degree does not fit in the index type");
+            }
+
+            core_number[vertex] = adjacent_vertices[vertex].size();
+            max_degree = std::max(max_degree, core_number[vertex]);
+        }
+
+        std::vector<Index> bucket_starts(static_cast<size_t>(max_degree) + 2, 0);
+        for (size_t vertex = 0; vertex < number_of_vertices; ++vertex) {
+            ++bucket_starts[core_number[vertex] + 1];
+        }
+        std::partial_sum(bucket_starts.begin(), bucket_starts.end(), bucket_starts.begin());
+
+        std::vector<Index> vertices(number_of_vertices);
+        std::vector<Index> positions(number_of_vertices);
+        for (size_t vertex = 0; vertex < number_of_vertices; ++vertex) {
+            const Index position = bucket_starts[core_number[vertex]]++;
+            vertices[position] = vertex;
+            positions[vertex] = position;
+        }
+
+        for (size_t degree = static_cast<size_t>(max_degree) + 1; degree > 0; --degree) {
+            bucket_starts[degree] = bucket_starts[degree - 1];
+        }
+        bucket_starts[0] = 0;
+
+        for (size_t position = 0; position < number_of_vertices; ++position) {
+            const Index vertex = vertices[position];
+
+            for (const Index adjacent_vertex: adjacent_vertices[vertex]) {
+                const Index adjacent_vertex_core_number = core_number[adjacent_vertex];
+
+                if (adjacent_vertex_core_number > core_number[vertex]) {
+                    const Index adjacent_vertex_position = positions[adjacent_vertex];
+                    const Index bucket_start = bucket_starts[adjacent_vertex_core_number];
+                    const Index first_vertex_in_bucket = vertices[bucket_start];
+
+                    if (adjacent_vertex != first_vertex_in_bucket) {
+                        vertices[adjacent_vertex_position] = first_vertex_in_bucket;
+                        positions[first_vertex_in_bucket] = adjacent_vertex_position;
+                        vertices[bucket_start] = adjacent_vertex;
+                        positions[adjacent_vertex] = bucket_start;
+                    }
+
+                    ++bucket_starts[adjacent_vertex_core_number];
+                    --core_number[adjacent_vertex];
+                }
+            }
+        }
+
+        link_in_order(vertices);
+
+        for (size_t vertex = 0; vertex < number_of_vertices; ++vertex) {
+            out_degrees[vertex] = count_adjacent_vertices_after(vertex);
+        }
+    }
+
+    // Derives a k-order from core_number: the vertices with core number k, which have at most k neighbors of core number at least k
+    // once the earlier ones are removed, are placed in the order they are peeled by removing those with at most k such neighbors,
+    // with a queue instead of the buckets of recalculate(), as the core numbers are known.
+    void order_by_core_number() {
+        const size_t number_of_vertices = adjacent_vertices.size();
+
+        // sort the vertices by core number
+        const Index max_core_number = number_of_vertices ? *std::max_element(core_number.begin(), core_number.end()) : 0;
+
+        std::vector<Index> shell_starts(static_cast<size_t>(max_core_number) + 2, 0);
+        for (size_t vertex = 0; vertex < number_of_vertices; ++vertex) {
+            ++shell_starts[core_number[vertex] + 1];
+        }
+        std::partial_sum(shell_starts.begin(), shell_starts.end(), shell_starts.begin());
+
+        std::vector<Index> vertices(number_of_vertices);
+        std::vector<Index> shell_positions(shell_starts.begin(), shell_starts.end() - 1);
+        for (size_t vertex = 0; vertex < number_of_vertices; ++vertex) {
+            vertices[shell_positions[core_number[vertex]]++] = vertex;
+        }
+
+        // remaining_degrees[v] is the number of neighbors of v with core number at least core_number[v] not yet placed,
+        // which reaches core_number[v] exactly once unless it starts at or below it
+        std::vector<Index> remaining_degrees(number_of_vertices);
+        for (size_t vertex = 0; vertex < number_of_vertices; ++vertex) {
+            remaining_degrees[vertex] = count_adjacent_vertices_with_core_number_of_at_least(vertex, core_number[vertex]);
+        }
+
+        std::vector<Index> order;
+        order.reserve(number_of_vertices);
+
+        for (size_t k = 0; k <= max_core_number; ++k) {
+            for (size_t position = shell_starts[k]; position < shell_starts[k + 1]; ++position) {
+                if (remaining_degrees[vertices[position]] <= k) {
+                    order.push_back(vertices[position]);
+                }
+            }
+
+            for (size_t position = shell_starts[k]; position < order.size(); ++position) {
+                for (const Index adjacent_vertex: adjacent_vertices[order[position]]) {
+                    if (core_number[adjacent_vertex] == k && --remaining_degrees[adjacent_vertex] == k) {
+                        order.push_back(adjacent_vertex);
+                    }
+                }
+            }
+
+            if (order.size() != shell_starts[k + 1]) {
+                throw std::invalid_argument("DynamicCoreNumber: the core numbers are not those of the graph");
+            }
+        }
+
+        link_in_order(order);
+
+        for (size_t vertex = 0; vertex < number_of_vertices; ++vertex) {
+            out_degrees[vertex] = count_adjacent_vertices_after(vertex);
+        }
+    }
+
+    // Adds uv, where u precedes v in the k-order and k = core_number[u]. If u then has more than k neighbors after it,
+    // scans the vertices with core number k from u onwards for the candidates for core number k + 1, which move after all of them:
+    //     extra_out_degrees[w]     the number of candidates adjacent to an unscanned vertex w, which will be after w instead of before it
+    //     counts[c]                the number of neighbors of a candidate c that may still be in the (k + 1)-core: those with a larger
+    //                              core number, the candidates, and the unscanned vertices
+    // A scanned vertex w with out_degrees[w] + extra_out_degrees[w] > k becomes a candidate. Otherwise it stays, and no longer counts
+    // toward its adjacent candidates, which are evicted once they count at most k neighbors, and placed in the k-order after w.
+    // Only the vertices with extra_out_degrees[w] > 0 are scanned, in the k-order, as the others keep their out-degrees.
+    // The candidates never evicted move to the front of the vertices with core number k + 1.
+    void insert_edge(Index u, Index v) {
+        adjacent_vertices[u].push_back(v);
+        adjacent_vertices[v].push_back(u);
+        ++number_of_edges;
+
+        if (precedes(v, u)) {
+            std::swap(u, v);
+        }
+
+        const Index k = core_number[u];
+        if (++out_degrees[u] <= k) {
+            return;
+        }
+
+        touch(u);
+        add_candidate(u, k);
+
+        while (!scan_queue.empty()) {
+            const Index vertex = pop_scan_queue();
+
+            if (states[vertex] != queued) {
+                continue;
+            }
+
+            if (extra_out_degrees[vertex] == 0) {
+                states[vertex] = scanned;
+            }
+            else if (out_degrees[vertex] + extra_out_degrees[vertex] > k) {
+                add_candidate(vertex, k);
+            }
+            else {
+                out_degrees[vertex] += extra_out_degrees[vertex];
+                states[vertex] = scanned;
+
+                // the adjacent candidates lose vertex before any of them is evicted and placed after it
+                for (const Index adjacent_vertex: adjacent_vertices[vertex]) {
+                    if (states[adjacent_vertex] == candidate) {
+                        --counts[adjacent_vertex];
+                    }
+                }
+
+                Index insertion_point = vertex;
+                for (const Index adjacent_vertex: adjacent_vertices[vertex]) {
+                    if (states[adjacent_vertex] == candidate && counts[adjacent_vertex] <= k) {
+                        insertion_point = evict_candidates(adjacent_vertex, insertion_point, k);
+                    }
+                }
+            }
+        }
+
+        // promote the candidates, keeping their order, and count their neighbors after them in the k-order
+        promoted_vertices.clear();
+        for (const Index vertex: candidates) {
+            if (states[vertex] == candidate) {
+                promoted_vertices.push_back(vertex);
+                core_number[vertex] = k + 1;
+            }
+        }
+
+        link_before_head(promoted_vertices, k + 1);
+
+        for (const Index vertex: promoted_vertices) {
+            out_degrees[vertex] = count_adjacent_vertices_after(vertex);
+        }
+
+        candidates.clear();
+        reset_touched_vertices();
+    }
+
+    // Removes uv, then demotes the vertices with core number r = min(core_number[u], core_number[v]) that are left with fewer than r
+    // neighbors of core number at least r, counted in counts[w] when the removal of uv or a demoted neighbor first affects w,
+    // and decremented once per edge to each demoted neighbor.
+    // The demoted vertices move to the back of the vertices with core number r - 1, in the order they are demoted,
+    // where the neighbors after each are those counted in counts[w] when it is demoted.
+    void remove_edge(const Index u, const Index v) {
+        --out_degrees[precedes(u, v) ? u : v];
+        remove_adjacent_vertex(u, v);
+        remove_adjacent_vertex(v, u);
+        --number_of_edges;
+
+        const Index r = std::min(core_number[u], core_number[v]);
+        if (r == 0) {
+            return;
+        }
+
+        for (const Index root: { u, v }) {
+            if (core_number[root] == r && states[root] == unvisited) {
+                start_demotion_count(root, r);
+                demote_if_below(root, r);
+            }
+        }
+
+        // a demoted vertex keeps core number r until it has decremented the count of each neighbor with core number r,
+        // so that the neighbors it affects first start from a count including it
+        while (!demoted_vertices.empty()) {
+            const Index vertex = demoted_vertices.back();
+            demoted_vertices.pop_back();
+
+            for (const Index adjacent_vertex: adjacent_vertices[vertex]) {
+                if (core_number[adjacent_vertex] != r) {
+                    continue;
+                }
+
+                if (states[adjacent_vertex] == unvisited) {
+                    start_demotion_count(adjacent_vertex, r);
+                }
+
+                --counts[adjacent_vertex];
+                demote_if_below(adjacent_vertex, r);
+
+                if (precedes(adjacent_vertex, vertex)) {
+                    --out_degrees[adjacent_vertex];
+                }
+            }
+
+            out_degrees[vertex] = counts[vertex];
+            unlink(vertex);
+            core_number[vertex] = r - 1;
+            link_after(vertex, tails[r - 1], r - 1);
+        }
+
+        reset_touched_vertices();
+    }
+
+private:
+    enum State: uint8_t {
+        unvisited,
+        queued,
+        scanned,
+        candidate,
+        evicting,
+        evicted
+    };
+
+    // scratch space for one update, of which only the touched vertices are reset afterwards
+    std::vector<Index> counts;
+    std::vector<Index> extra_out_degrees;
+    std::vector<State> states;
+    std::vector<Index> touched_vertices;
+    std::vector<Index> scan_queue;
+    std::vector<Index> candidates;
+    std::vector<Index> evicted_vertices;
+    std::vector<Index> promoted_vertices;
+    std::vector<Index> demoted_vertices;
+
+    template <typename Graph> void copy_adjacent_vertices(const Graph& graph) {
+        const auto vertex_index_map = boost::get(boost::vertex_index, graph);
+
+        typename boost::graph_traits<Graph>::vertex_iterator vertex_iterator, vertex_end;
+        for (std::tie(vertex_iterator, vertex_end) = boost::vertices(graph); vertex_iterator != vertex_end; ++vertex_iterator) {
+            std::vector<Index>& vertex_adjacent_vertices = adjacent_vertices[boost::get(vertex_index_map, *vertex_iterator)];
+            vertex_adjacent_vertices.reserve(boost::degree(*vertex_iterator, graph));
+
+            typename boost::graph_traits<Graph>::adjacency_iterator adjacency_iterator, adjacency_end;
+            for (std::tie(adjacency_iterator, adjacency_end) = boost::adjacent_vertices(*vertex_iterator, graph); adjacency_iterator != adjacency_end; ++adjacency_iterator) {
+                vertex_adjacent_vertices.push_back(boost::get(vertex_index_map, *adjacency_iterator));
+            }
+        }
+
+        number_of_edges = boost::num_edges(graph);
+    }
+
+    bool precedes(const Index first, const Index second) const {
+        return core_number[first] < core_number[second] || (core_number[first] == core_number[second] && labels[first] < labels[second]);
+    }
+
+    Index count_adjacent_vertices_after(const Index vertex) const {
+        Index count = 0;
+        for (const Index adjacent_vertex: adjacent_vertices[vertex]) {
+            count += precedes(vertex, adjacent_vertex);
+        }
+
+        return count;
+    }
+
+    Index count_adjacent_vertices_with_core_number_of_at_least(const Index vertex, const Index r) const {
+        Index count = 0;
+        for (const Index adjacent_vertex: adjacent_vertices[vertex]) {
+            count += core_number[adjacent_vertex] >= r;
+        }
+
+        return count;
+    }
+
+    void touch(const Index vertex) {
+        touched_vertices.push_back(vertex);
+    }
+
+    void reset_touched_vertices() {
+        for (const Index vertex: touched_vertices) {
+            extra_out_degrees[vertex] = 0;
+            states[vertex] = unvisited;
+        }
+
+        touched_vertices.clear();
+    }
+
+    // scan_queue is a heap with the earliest vertex in the k-order on top
+    void push_scan_queue(const Index vertex) {
+        scan_queue.push_back(vertex);
+        std::push_heap(
+            scan_queue.begin(),
+            scan_queue.end(),
+            [this](const Index first, const Index second) {
+                return precedes(second, first);
+            }
+        );
+    }
+
+    Index pop_scan_queue() {
+        std::pop_heap(
+            scan_queue.begin(),
+            scan_queue.end(),
+            [this](const Index first, const Index second) {
+                return precedes(second, first);
+            }
+        );
+        const Index vertex = scan_queue.back();
+        scan_queue.pop_back();
+
+        return vertex;
+    }
+
+    // counts[vertex] starts at the neighbors after it and the candidates before it, and the unscanned vertices after it gain it as an extra out-neighbor
+    void add_candidate(const Index vertex, const Index k) {
+        states[vertex] = candidate;
+        counts[vertex] = out_degrees[vertex] + extra_out_degrees[vertex];
+        candidates.push_back(vertex);
+
+        for (const Index adjacent_vertex: adjacent_vertices[vertex]) {
+            if (core_number[adjacent_vertex] == k && states[adjacent_vertex] <= queued && precedes(vertex, adjacent_vertex)) {
+                if (states[adjacent_vertex] == unvisited) {
+                    touch(adjacent_vertex);
+                    states[adjacent_vertex] = queued;
+                    push_scan_queue(adjacent_vertex);
+                }
+
+                ++extra_out_degrees[adjacent_vertex];
+            }
+        }
+
+        unlink(vertex);
+    }
+
+    // Evicts vertex and the candidates left with at most k neighbors that may be in the (k + 1)-core in turn,
+    // placing each after insertion_point in the order they are evicted, and returns the last one placed.
+    // An evicted vertex precedes the unscanned vertices again, and is followed by all the neighbors it still counts,
+    // so the candidates waiting to be placed (evicting) keep losing the neighbors placed before them.
+    Index evict_candidates(const Index vertex, Index insertion_point, const Index k) {
+        states[vertex] = evicting;
+        evicted_vertices.push_back(vertex);
+
+        while (!evicted_vertices.empty()) {
+            const Index evicted_vertex = evicted_vertices.back();
+            evicted_vertices.pop_back();
+
+            states[evicted_vertex] = evicted;
+            out_degrees[evicted_vertex] = counts[evicted_vertex];
+            link_after(evicted_vertex, insertion_point, k);
+            insertion_point = evicted_vertex;
+
+            for (const Index adjacent_vertex: adjacent_vertices[evicted_vertex]) {
+                if (states[adjacent_vertex] == candidate) {
+                    if (--counts[adjacent_vertex] <= k) {
+                        states[adjacent_vertex] = evicting;
+                        evicted_vertices.push_back(adjacent_vertex);
+                    }
+                }
+                else if (states[adjacent_vertex] == evicting) {
+                    --counts[adjacent_vertex];
+                }
+                else if (states[adjacent_vertex] == queued) {
+                    --extra_out_degrees[adjacent_vertex];
+                }
+            }
+        }
+
+        return insertion_point;
+    }
+
+    // the counted vertices are scanned, and the demoted ones evicted, so that they are pushed to demoted_vertices once
+    void start_demotion_count(const Index vertex, const Index r) {
+        touch(vertex);
+        states[vertex] = scanned;
+        counts[vertex] = count_adjacent_vertices_with_core_number_of_at_least(vertex, r);
+    }
+
+    void demote_if_below(const Index vertex, const Index r) {
+        if (states[vertex] == scanned && counts[vertex] < r) {
+            states[vertex] = evicted;
+            demoted_vertices.push_back(vertex);
+        }
+    }
+
+    void unlink(const Index vertex) {
+        const Index k = core_number[vertex];
+        const Index previous_vertex = previous_vertices[vertex], next_vertex = next_vertices[vertex];
+
+        (previous_vertex == null_vertex ? heads[k] : next_vertices[previous_vertex]) = next_vertex;
+        (next_vertex == null_vertex ? tails[k] : previous_vertices[next_vertex]) = previous_vertex;
+    }
+
+    // links vertex into the list of core number k after previous_vertex, or at its head if previous_vertex is null_vertex,
+    // with a label between those of its neighbors in the list, relabeling the list if there is none
+    void link_after(const Index vertex, const Index previous_vertex, const Index k) {
+        if (k >= heads.size()) {
+            heads.resize(static_cast<size_t>(k) + 1, null_vertex);
+            tails.resize(static_cast<size_t>(k) + 1, null_vertex);
+        }
+
+        const Index next_vertex = (previous_vertex == null_vertex) ? heads[k] : next_vertices[previous_vertex];
+
+        previous_vertices[vertex] = previous_vertex;
+        next_vertices[vertex] = next_vertex;
+        (previous_vertex == null_vertex ? heads[k] : next_vertices[previous_vertex]) = vertex;
+        (next_vertex == null_vertex ? tails[k] : previous_vertices[next_vertex]) = vertex;
+
+        const uint64_t lower_label = (previous_vertex == null_vertex) ? 0 : labels[previous_vertex];
+        const uint64_t upper_label = (next_vertex == null_vertex) ? std::numeric_limits<uint64_t>::max() : labels[next_vertex];
+
+        if (upper_label - lower_label >= 2) {
+            labels[vertex] = lower_label + (upper_label - lower_label) / 2;
+        }
+        else {
+            relabel(k);
+        }
+    }
+
+    // links all vertices, given in the k-order, into the lists of their core numbers
+    void link_in_order(const std::vector<Index>& order) {
+        const Index max_core_number = order.empty() ? 0 : core_number[order.back()];
+        heads.assign(static_cast<size_t>(max_core_number) + 1, null_vertex);
+        tails.assign(static_cast<size_t>(max_core_number) + 1, null_vertex);
+
+        for (const Index vertex: order) {
+            const Index k = core_number[vertex];
+
+            previous_vertices[vertex] = tails[k];
+            next_vertices[vertex] = null_vertex;
+            (tails[k] == null_vertex ? heads[k] : next_vertices[tails[k]]) = vertex;
+            tails[k] = vertex;
+        }
+
+        for (size_t k = 0; k < heads.size(); ++k) {
+            relabel(k);
+        }
+    }
+
+    // links vertices, in order, at the head of the list of core number k
+    void link_before_head(const std::vector<Index>& vertices, const Index k) {
+        for (auto vertex_iterator = vertices.rbegin(); vertex_iterator != vertices.rend(); ++vertex_iterator) {
+            link_after(*vertex_iterator, null_vertex, k);
+        }
+    }
+
+    // spreads the labels of the list of core number k evenly over [2^62, 2^63), leaving room at both ends
+    void relabel(const Index k) {
+        size_t length = 0;
+        for (Index vertex = heads[k]; vertex != null_vertex; vertex = next_vertices[vertex]) {
+            ++length;
+        }
+
+        const uint64_t spacing = (uint64_t(1) << 62) / (length + 1);
+        uint64_t label = uint64_t(1) << 62;
+        for (Index vertex = heads[k]; vertex != null_vertex; vertex = next_vertices[vertex]) {
+            labels[vertex] = label;
+            label += spacing;
+        }
+    }
+
+    void remove_adjacent_vertex(const Index vertex, const Index adjacent_vertex) {
+        std::vector<Index>& vertex_adjacent_vertices = adjacent_vertices[vertex];
+        const auto position = std::find(vertex_adjacent_vertices.begin(), vertex_adjacent_vertices.end(), adjacent_vertex);
+        if (position == vertex_adjacent_vertices.end()) {
+            throw std::invalid_argument("DynamicCoreNumber: removing an edge not in the graph");
+        }
+
+        *position = vertex_adjacent_vertices.back();
+        vertex_adjacent_vertices.pop_back();
+    }
+};
+
+#endif
@@ -0,0 +1,112 @@
+#ifndef FILTER_CSR_GRAPH_HPP
+#define FILTER_CSR_GRAPH_HPP
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <limits>
+#include <memory>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "csr_graph.hpp"
+
+
+// The arrays of a CSRGraph made by filtering another CSRGraph, which shares the name table of the original.
+struct FilteredCSRGraphArrays {
+    std::shared_ptr<const void> original_storage;
+    std::vector<uint64_t> offsets;
+    std::vector<uint32_t> neighbors;
+    std::vector<uint32_t> edge_indices;
+    std::vector<uint32_t> edge_sources;
+    std::vector<uint32_t> edge_targets;
+};
+
+// Materializes the subgraph of a CSRGraph with the edges satisfying edge_predicate (e.g., IsEdgeDescriptorInEdgeSet),
+// as a compact CSRGraph to be traversed without evaluating the predicate again.
+// Unlike boost::filtered_graph, it keeps all vertices with the same vertex descriptors (and names),
+// so that vectors indexed by vertex index remain valid for it, and edges are renumbered densely in the same order.
+template <typename EdgePredicate> CSRGraph filter_csr_graph_edges(
+    const CSRGraph& graph,
+    const EdgePredicate& edge_predicate
+) {
+    std::shared_ptr<FilteredCSRGraphArrays> filtered_csr_graph_arrays = std::make_shared<FilteredCSRGraphArrays>();
+    filtered_csr_graph_arrays->original_storage = graph.storage;
+
+    // renumber the remaining edges in ascending order of edge index
+    const uint32_t removed = std::numeric_limits<uint32_t>::max();
+    std::vector<uint32_t> edge_index_to_filtered_edge_index(graph.number_of_edges, removed);
+
+    CSRGraph::edge_iterator edge_iterator, edge_end;
+    for (std::tie(edge_iterator, edge_end) = boost::edges(graph); edge_iterator != edge_end; ++edge_iterator) {
+        const CSRGraphEdgeDescriptor edge_descriptor = *edge_iterator;
+
+        if (edge_predicate(edge_descriptor)) {
+            edge_index_to_filtered_edge_index[edge_descriptor.index] = filtered_csr_graph_arrays->edge_sources.size();
+            filtered_csr_graph_arrays->edge_sources.push_back(edge_descriptor.source);
+            filtered_csr_graph_arrays->edge_targets.push_back(edge_descriptor.target);
+        }
+    }
+
+    const size_t number_of_filtered_edges = filtered_csr_graph_arrays->edge_sources.size();
+
+    // keep the remaining out-edges of each vertex, which stay in ascending order of edge index
+    std::vector<uint64_t>& offsets = filtered_csr_graph_arrays->offsets;
+    std::vector<uint32_t>& neighbors = filtered_csr_graph_arrays->neighbors;
+    std::vector<uint32_t>& edge_indices = filtered_csr_graph_arrays->edge_indices;
+
+    offsets.reserve(graph.number_of_vertices + 1);
+    neighbors.reserve(2 * number_of_filtered_edges);
+    edge_indices.reserve(2 * number_of_filtered_edges);
+
+    offsets.push_back(0);
+    for (size_t vertex = 0; vertex < graph.number_of_vertices; ++vertex) {
+        for (uint64_t position = graph.offsets[vertex]; position < graph.offsets[vertex + 1]; ++position) {
+            const uint32_t filtered_edge_index = edge_index_to_filtered_edge_index[graph.edge_indices[position]];
+
+            if (filtered_edge_index != removed) {
+                neighbors.push_back(graph.neighbors[position]);
+                edge_indices.push_back(filtered_edge_index);
+            }
+        }
+
+        offsets.push_back(neighbors.size());
+    }
+
+    CSRGraph filtered_graph;
+    filtered_graph.number_of_vertices = graph.number_of_vertices;
+    filtered_graph.number_of_edges = number_of_filtered_edges;
+    filtered_graph.name_offsets = graph.name_offsets;
+    filtered_graph.names = graph.names;
+    filtered_graph.offsets = offsets.data();
+    filtered_graph.neighbors = neighbors.data();
+    filtered_graph.edge_indices = edge_indices.data();
+    filtered_graph.edge_sources = filtered_csr_graph_arrays->edge_sources.data();
+    filtered_graph.edge_targets = filtered_csr_graph_arrays->edge_targets.data();
+    filtered_graph.storage = std::move(filtered_csr_graph_arrays);
+
+    return filtered_graph;
+}
+
+// Materializes the subgraph of a CSRGraph induced by the vertices satisfying vertex_predicate
+// (e.g., DoesVertexDescriptorCorenessSatisfyRequirement), i.e., with the edges between such vertices,
+// keeping the other vertices as isolated vertices like filter_csr_graph_edges().
+template <typename VertexPredicate> CSRGraph filter_csr_graph_vertices(
+    const CSRGraph& graph,
+    const VertexPredicate& vertex_predicate
+) {
+    std::vector<bool> is_vertex_kept(graph.number_of_vertices);
+    for (uint32_t vertex = 0; vertex < graph.number_of_vertices; ++vertex) {
+        is_vertex_kept[vertex] = vertex_predicate(vertex);
+    }
+
+    return filter_csr_graph_edges(
+        graph,
+        [&is_vertex_kept](const CSRGraphEdgeDescriptor& edge_descriptor) {
+            return is_vertex_kept[edge_descriptor.source] && is_vertex_kept[edge_descriptor.target];
+        }
+    );
+}
+
+#endif
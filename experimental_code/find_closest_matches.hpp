@@ -1,9 +1,12 @@
 #ifndef FIND_CLOSEST_MATCHES_HPP
 #define FIND_CLOSEST_MATCHES_HPP
 
+#include <stddef.h>
+
 #include "move_forward_to_find_next_minima.hpp"
 #include "point.h"
 #include "trajectory.h"
+#include "trajectory_store.hpp"
 
 
 template <typename Consumer> void find_closest_matches(
@@ -35,5 +38,34 @@ template <typename Consumer> void find_closest_matches(
     }
 }
 
-#endif
+// find_closest_matches() for trajectory views, passing the indices of the matching points to consumer
+template <typename Consumer> void find_closest_matches(
+    const TrajectoryView& from,
+    const TrajectoryView& to,
+    const Consumer& consumer
+) {
+    size_t source_index = 0;
+    const size_t source_end = from.size();
+    
+    if (source_index == source_end) return;
+    
+    for (
+        size_t target_index = 0;
+        target_index != to.size();
+        ++target_index
+    ) {
+        source_index = move_forward_to_find_next_minima(
+            source_index,
+            source_end,
+            [&from, &to, target_index](const size_t t_source_index) {
+                return (from.timestamps[t_source_index] > to.timestamps[target_index]) ?
+                    (from.timestamps[t_source_index] - to.timestamps[target_index]) :
+                    (to.timestamps[target_index] - from.timestamps[t_source_index]);
+            }
+        );
+        
+        consumer(source_index, target_index);
+    }
+}
 
+#endif
@@ -7,6 +7,7 @@
 #define HAVERSINE_HPP
 
 #include <math.h>
+#include <stddef.h>
 
 
 const double EARTH_RADIUS = 6372797.560856;
@@ -26,10 +27,499 @@ double haversine(
     // the square of half the chord length between the points
     double a = sin(latitude_delta_in_radians / 2) * sin(latitude_delta_in_radians / 2) + cos(first_latitude_in_radians) * cos(second_latitude_in_radians) * sin(longitude_delta_in_radians / 2) * sin(longitude_delta_in_radians / 2);
     
-    // angular distance in radians
-    double c = 2 * atan2(sqrt(a), sqrt(1 - a));
+    // angular distance in radians (a may exceed 1 by rounding for nearly antipodal points)
+    double c = 2 * atan2(sqrt(a), sqrt(fmax(0.0, 1 - a)));
     
     return EARTH_RADIUS * c;
 }
 
+// haversine() with the cosines of the latitudes in radians precomputed, e.g., by a TrajectoryStore
+double haversine(
+    double first_latitude,
+    double first_longitude,
+    double cos_first_latitude,
+    double second_latitude,
+    double second_longitude,
+    double cos_second_latitude
+) {
+    double latitude_delta_in_radians = (second_latitude - first_latitude) * DEGREES_TO_RADIANS;
+    double longitude_delta_in_radians = (second_longitude - first_longitude) * DEGREES_TO_RADIANS;
+    
+    // the square of half the chord length between the points
+    double a = sin(latitude_delta_in_radians / 2) * sin(latitude_delta_in_radians / 2) + cos_first_latitude * cos_second_latitude * sin(longitude_delta_in_radians / 2) * sin(longitude_delta_in_radians / 2);
+    
+    // angular distance in radians (a may exceed 1 by rounding for nearly antipodal points)
+    double c = 2 * atan2(sqrt(a), sqrt(fmax(0.0, 1 - a)));
+    
+    return EARTH_RADIUS * c;
+}
+
+// The batched kernels compute haversine() for many pairs of points given as structure-of-arrays spans.
+// The scalar ones are loops over the libm functions that hoist the terms of a shared point and avoid a call per pair.
+
+// distances[i] = haversine(first_latitude, first_longitude, second_latitudes[i], second_longitudes[i]), with the terms of the first point computed once
+void haversine_one_to_many_scalar(
+    const double first_latitude,
+    const double first_longitude,
+    const double* second_latitudes,
+    const double* second_longitudes,
+    const size_t number_of_second_points,
+    double* distances
+) {
+    const double first_latitude_in_radians = first_latitude * DEGREES_TO_RADIANS;
+    const double cos_first_latitude = cos(first_latitude_in_radians);
+
+    for (size_t i = 0; i < number_of_second_points; ++i) {
+        double second_latitude_in_radians = second_latitudes[i] * DEGREES_TO_RADIANS;
+        double latitude_delta_in_radians = (second_latitudes[i] - first_latitude) * DEGREES_TO_RADIANS;
+        double longitude_delta_in_radians = (second_longitudes[i] - first_longitude) * DEGREES_TO_RADIANS;
+
+        double sin_half_latitude_delta = sin(latitude_delta_in_radians / 2);
+        double sin_half_longitude_delta = sin(longitude_delta_in_radians / 2);
+
+        double a = sin_half_latitude_delta * sin_half_latitude_delta + cos_first_latitude * cos(second_latitude_in_radians) * sin_half_longitude_delta * sin_half_longitude_delta;
+
+        double c = 2 * atan2(sqrt(a), sqrt(fmax(0.0, 1 - a)));
+
+        distances[i] = EARTH_RADIUS * c;
+    }
+}
+
+// distances[i] = haversine(first_latitudes[i], first_longitudes[i], second_latitude, second_longitude), with the terms of the second point computed once
+void haversine_many_to_one_scalar(
+    const double* first_latitudes,
+    const double* first_longitudes,
+    const size_t number_of_first_points,
+    const double second_latitude,
+    const double second_longitude,
+    double* distances
+) {
+    const double second_latitude_in_radians = second_latitude * DEGREES_TO_RADIANS;
+    const double cos_second_latitude = cos(second_latitude_in_radians);
+
+    for (size_t i = 0; i < number_of_first_points; ++i) {
+        double first_latitude_in_radians = first_latitudes[i] * DEGREES_TO_RADIANS;
+        double latitude_delta_in_radians = (second_latitude - first_latitudes[i]) * DEGREES_TO_RADIANS;
+        double longitude_delta_in_radians = (second_longitude - first_longitudes[i]) * DEGREES_TO_RADIANS;
+
+        double sin_half_latitude_delta = sin(latitude_delta_in_radians / 2);
+        double sin_half_longitude_delta = sin(longitude_delta_in_radians / 2);
+
+        double a = sin_half_latitude_delta * sin_half_latitude_delta + cos(first_latitude_in_radians) * cos_second_latitude * sin_half_longitude_delta * sin_half_longitude_delta;
+
+        double c = 2 * atan2(sqrt(a), sqrt(fmax(0.0, 1 - a)));
+
+        distances[i] = EARTH_RADIUS * c;
+    }
+}
+
+// distances[i] = haversine(first_latitudes[i], first_longitudes[i], second_latitudes[i], second_longitudes[i])
+void haversine_pairwise_scalar(
+    const double* first_latitudes,
+    const double* first_longitudes,
+    const double* second_latitudes,
+    const double* second_longitudes,
+    const size_t number_of_pairs,
+    double* distances
+) {
+    for (size_t i = 0; i < number_of_pairs; ++i) {
+        double first_latitude_in_radians = first_latitudes[i] * DEGREES_TO_RADIANS;
+        double second_latitude_in_radians = second_latitudes[i] * DEGREES_TO_RADIANS;
+        double latitude_delta_in_radians = (second_latitudes[i] - first_latitudes[i]) * DEGREES_TO_RADIANS;
+        double longitude_delta_in_radians = (second_longitudes[i] - first_longitudes[i]) * DEGREES_TO_RADIANS;
+
+        double sin_half_latitude_delta = sin(latitude_delta_in_radians / 2);
+        double sin_half_longitude_delta = sin(longitude_delta_in_radians / 2);
+
+        double a = sin_half_latitude_delta * sin_half_latitude_delta + cos(first_latitude_in_radians) * cos(second_latitude_in_radians) * sin_half_longitude_delta * sin_half_longitude_delta;
+
+        double c = 2 * atan2(sqrt(a), sqrt(fmax(0.0, 1 - a)));
+
+        distances[i] = EARTH_RADIUS * c;
+    }
+}
+
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#define HAVERSINE_HAS_AVX2_KERNELS
+#endif
+
+#ifdef HAVERSINE_HAS_AVX2_KERNELS
+
+#include <immintrin.h>
+
+// The AVX2 kernels compute 4 distances at once with Cephes' sin(), cos(), and atan() (https://www.netlib.org/cephes/) on vectors,
+// which agree with libm to within a few ulps, so their distances differ from haversine() by a relative error of about 1e-15.
+// Each distance depends only on its own pair of points, not on its position in the batch (the last block is padded),
+// so the kernels agree with each other, and a pair with a coordinate beyond HAVERSINE_AVX2_MAX_ABSOLUTE_COORDINATE degrees
+// (or a NaN one), where the argument reduction would lose accuracy, falls back to haversine().
+#define HAVERSINE_AVX2 __attribute__((target("avx2")))
+
+const double HAVERSINE_AVX2_MAX_ABSOLUTE_COORDINATE = 1e6;
+
+// the multiple of pi / 4 nearest below |x| (rounded up to an even one), and the remainder of |x|,
+// from which sin(x) and cos(x) are evaluated by the polynomials below as in Cephes' sin.c
+HAVERSINE_AVX2 inline void reduce_haversine_avx2_trigonometric_argument(const __m256d x, __m256d& octant, __m256d& remainder) {
+    const __m256d absolute_x = _mm256_andnot_pd(_mm256_set1_pd(-0.0), x);
+
+    __m256d multiple = _mm256_round_pd(_mm256_mul_pd(absolute_x, _mm256_set1_pd(4 / M_PI)), _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC);
+    const __m256d is_odd = _mm256_sub_pd(multiple, _mm256_mul_pd(_mm256_set1_pd(2), _mm256_round_pd(_mm256_mul_pd(multiple, _mm256_set1_pd(0.5)), _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC)));
+    multiple = _mm256_add_pd(multiple, is_odd);
+
+    octant = _mm256_sub_pd(multiple, _mm256_mul_pd(_mm256_set1_pd(8), _mm256_round_pd(_mm256_mul_pd(multiple, _mm256_set1_pd(0.125)), _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC)));
+
+    // pi / 4 in three parts, so that the products with multiple are exact
+    remainder = _mm256_sub_pd(absolute_x, _mm256_mul_pd(multiple, _mm256_set1_pd(7.85398125648498535156E-1)));
+    remainder = _mm256_sub_pd(remainder, _mm256_mul_pd(multiple, _mm256_set1_pd(3.77489470793079817668E-8)));
+    remainder = _mm256_sub_pd(remainder, _mm256_mul_pd(multiple, _mm256_set1_pd(2.69515142907905952645E-15)));
+}
+
+// sin(remainder) for |remainder| <= pi / 4
+HAVERSINE_AVX2 inline __m256d evaluate_haversine_avx2_sin_polynomial(const __m256d remainder) {
+    const __m256d square = _mm256_mul_pd(remainder, remainder);
+
+    __m256d polynomial = _mm256_set1_pd(1.58962301576546568060E-10);
+    polynomial = _mm256_add_pd(_mm256_mul_pd(polynomial, square), _mm256_set1_pd(-2.50507477628578072866E-8));
+    polynomial = _mm256_add_pd(_mm256_mul_pd(polynomial, square), _mm256_set1_pd(2.75573136213857245213E-6));
+    polynomial = _mm256_add_pd(_mm256_mul_pd(polynomial, square), _mm256_set1_pd(-1.98412698295895385996E-4));
+    polynomial = _mm256_add_pd(_mm256_mul_pd(polynomial, square), _mm256_set1_pd(8.33333333332211858878E-3));
+    polynomial = _mm256_add_pd(_mm256_mul_pd(polynomial, square), _mm256_set1_pd(-1.66666666666666307295E-1));
+
+    return _mm256_add_pd(remainder, _mm256_mul_pd(_mm256_mul_pd(remainder, square), polynomial));
+}
+
+// cos(remainder) for |remainder| <= pi / 4
+HAVERSINE_AVX2 inline __m256d evaluate_haversine_avx2_cos_polynomial(const __m256d remainder) {
+    const __m256d square = _mm256_mul_pd(remainder, remainder);
+
+    __m256d polynomial = _mm256_set1_pd(-1.13585365213876817300E-11);
+    polynomial = _mm256_add_pd(_mm256_mul_pd(polynomial, square), _mm256_set1_pd(2.08757008419747316778E-9));
+    polynomial = _mm256_add_pd(_mm256_mul_pd(polynomial, square), _mm256_set1_pd(-2.75573141792967388112E-7));
+    polynomial = _mm256_add_pd(_mm256_mul_pd(polynomial, square), _mm256_set1_pd(2.48015872888517045348E-5));
+    polynomial = _mm256_add_pd(_mm256_mul_pd(polynomial, square), _mm256_set1_pd(-1.38888888888730564116E-3));
+    polynomial = _mm256_add_pd(_mm256_mul_pd(polynomial, square), _mm256_set1_pd(4.16666666666665929218E-2));
+
+    return _mm256_add_pd(
+        _mm256_sub_pd(_mm256_set1_pd(1), _mm256_mul_pd(square, _mm256_set1_pd(0.5))),
+        _mm256_mul_pd(_mm256_mul_pd(square, square), polynomial)
+    );
+}
+
+HAVERSINE_AVX2 inline __m256d haversine_avx2_sin(const __m256d x) {
+    __m256d octant, remainder;
+    reduce_haversine_avx2_trigonometric_argument(x, octant, remainder);
+
+    // in octants 2 and 6, sin is cos of the remainder, and it is negative in octants 4 and 6 (of |x|) and for negative x
+    const __m256d is_cos = _mm256_or_pd(_mm256_cmp_pd(octant, _mm256_set1_pd(2), _CMP_EQ_OQ), _mm256_cmp_pd(octant, _mm256_set1_pd(6), _CMP_EQ_OQ));
+    const __m256d is_negative = _mm256_cmp_pd(octant, _mm256_set1_pd(4), _CMP_GE_OQ);
+
+    const __m256d value = _mm256_blendv_pd(evaluate_haversine_avx2_sin_polynomial(remainder), evaluate_haversine_avx2_cos_polynomial(remainder), is_cos);
+    const __m256d sign = _mm256_xor_pd(_mm256_and_pd(is_negative, _mm256_set1_pd(-0.0)), _mm256_and_pd(x, _mm256_set1_pd(-0.0)));
+
+    return _mm256_xor_pd(value, sign);
+}
+
+HAVERSINE_AVX2 inline __m256d haversine_avx2_cos(const __m256d x) {
+    __m256d octant, remainder;
+    reduce_haversine_avx2_trigonometric_argument(x, octant, remainder);
+
+    // in octants 2 and 6, cos is sin of the remainder, and it is negative in octants 2 and 4
+    const __m256d is_sin = _mm256_or_pd(_mm256_cmp_pd(octant, _mm256_set1_pd(2), _CMP_EQ_OQ), _mm256_cmp_pd(octant, _mm256_set1_pd(6), _CMP_EQ_OQ));
+    const __m256d is_negative = _mm256_or_pd(_mm256_cmp_pd(octant, _mm256_set1_pd(2), _CMP_EQ_OQ), _mm256_cmp_pd(octant, _mm256_set1_pd(4), _CMP_EQ_OQ));
+
+    const __m256d value = _mm256_blendv_pd(evaluate_haversine_avx2_cos_polynomial(remainder), evaluate_haversine_avx2_sin_polynomial(remainder), is_sin);
+
+    return _mm256_xor_pd(value, _mm256_and_pd(is_negative, _mm256_set1_pd(-0.0)));
+}
+
+// atan2(y, x) for y, x >= 0, from atan() of min(y, x) / max(y, x) in [0, 1] as in Cephes' atan.c
+HAVERSINE_AVX2 inline __m256d haversine_avx2_atan2(const __m256d y, const __m256d x) {
+    const __m256d is_swapped = _mm256_cmp_pd(y, x, _CMP_GT_OQ);
+    const __m256d ratio = _mm256_div_pd(_mm256_min_pd(y, x), _mm256_max_pd(y, x));
+
+    // above 0.66, atan(ratio) = pi / 4 + atan((ratio - 1) / (ratio + 1)), whose argument is within [-0.21, 0.34]
+    const __m256d is_shifted = _mm256_cmp_pd(ratio, _mm256_set1_pd(0.66), _CMP_GT_OQ);
+    const __m256d argument = _mm256_blendv_pd(
+        ratio,
+        _mm256_div_pd(_mm256_sub_pd(ratio, _mm256_set1_pd(1)), _mm256_add_pd(ratio, _mm256_set1_pd(1))),
+        is_shifted
+    );
+
+    const __m256d square = _mm256_mul_pd(argument, argument);
+
+    __m256d numerator = _mm256_set1_pd(-8.750608600031904122785E-1);
+    numerator = _mm256_add_pd(_mm256_mul_pd(numerator, square), _mm256_set1_pd(-1.615753718733365076637E1));
+    numerator = _mm256_add_pd(_mm256_mul_pd(numerator, square), _mm256_set1_pd(-7.500855792314704667340E1));
+    numerator = _mm256_add_pd(_mm256_mul_pd(numerator, square), _mm256_set1_pd(-1.228866684490136173410E2));
+    numerator = _mm256_add_pd(_mm256_mul_pd(numerator, square), _mm256_set1_pd(-6.485021904942025371773E1));
+
+    __m256d denominator = _mm256_add_pd(square, _mm256_set1_pd(2.485846490142306297962E1));
+    denominator = _mm256_add_pd(_mm256_mul_pd(denominator, square), _mm256_set1_pd(1.650270098316988542046E2));
+    denominator = _mm256_add_pd(_mm256_mul_pd(denominator, square), _mm256_set1_pd(4.328810604912902668951E2));
+    denominator = _mm256_add_pd(_mm256_mul_pd(denominator, square), _mm256_set1_pd(4.853903996359136964868E2));
+    denominator = _mm256_add_pd(_mm256_mul_pd(denominator, square), _mm256_set1_pd(1.945506571482613964425E2));
+
+    __m256d angle = _mm256_div_pd(_mm256_mul_pd(square, numerator), denominator);
+    angle = _mm256_add_pd(_mm256_mul_pd(argument, angle), argument);
+
+    // pi / 4 and pi / 2 are added with the low-order bits lost in their doubles
+    const double pi_over_2_low_order_bits = 6.123233995736765886130E-17;
+    angle = _mm256_add_pd(
+        _mm256_and_pd(is_shifted, _mm256_set1_pd(M_PI_4)),
+        _mm256_add_pd(angle, _mm256_and_pd(is_shifted, _mm256_set1_pd(pi_over_2_low_order_bits / 2)))
+    );
+
+    return _mm256_blendv_pd(
+        angle,
+        _mm256_add_pd(_mm256_sub_pd(_mm256_set1_pd(M_PI_2), angle), _mm256_set1_pd(pi_over_2_low_order_bits)),
+        is_swapped
+    );
+}
+
+// haversine() of 4 pairs of points, with the cosines of the latitudes in radians given
+HAVERSINE_AVX2 inline __m256d haversine_avx2(
+    const __m256d first_latitudes,
+    const __m256d first_longitudes,
+    const __m256d cos_first_latitudes,
+    const __m256d second_latitudes,
+    const __m256d second_longitudes,
+    const __m256d cos_second_latitudes
+) {
+    const __m256d degrees_to_radians = _mm256_set1_pd(DEGREES_TO_RADIANS);
+    const __m256d latitude_deltas_in_radians = _mm256_mul_pd(_mm256_sub_pd(second_latitudes, first_latitudes), degrees_to_radians);
+    const __m256d longitude_deltas_in_radians = _mm256_mul_pd(_mm256_sub_pd(second_longitudes, first_longitudes), degrees_to_radians);
+
+    const __m256d sin_half_latitude_deltas = haversine_avx2_sin(_mm256_mul_pd(latitude_deltas_in_radians, _mm256_set1_pd(0.5)));
+    const __m256d sin_half_longitude_deltas = haversine_avx2_sin(_mm256_mul_pd(longitude_deltas_in_radians, _mm256_set1_pd(0.5)));
+
+    const __m256d a = _mm256_add_pd(
+        _mm256_mul_pd(sin_half_latitude_deltas, sin_half_latitude_deltas),
+        _mm256_mul_pd(_mm256_mul_pd(_mm256_mul_pd(cos_first_latitudes, cos_second_latitudes), sin_half_longitude_deltas), sin_half_longitude_deltas)
+    );
+
+    const __m256d c = _mm256_mul_pd(_mm256_set1_pd(2), haversine_avx2_atan2(_mm256_sqrt_pd(a), _mm256_sqrt_pd(_mm256_max_pd(_mm256_setzero_pd(), _mm256_sub_pd(_mm256_set1_pd(1), a)))));
+
+    return _mm256_mul_pd(_mm256_set1_pd(EARTH_RADIUS), c);
+}
+
+// the mask of the first number_of_lanes lanes, to load and store the last block of a span
+HAVERSINE_AVX2 inline __m256i get_haversine_avx2_lane_mask(const size_t number_of_lanes) {
+    return _mm256_cmpgt_epi64(_mm256_set1_epi64x(number_of_lanes), _mm256_setr_epi64x(0, 1, 2, 3));
+}
+
+// the bits of the lanes with a coordinate beyond HAVERSINE_AVX2_MAX_ABSOLUTE_COORDINATE or NaN
+HAVERSINE_AVX2 inline int get_haversine_avx2_fallback_lanes(
+    const __m256d first_latitudes,
+    const __m256d first_longitudes,
+    const __m256d second_latitudes,
+    const __m256d second_longitudes
+) {
+    const __m256d sign_mask = _mm256_set1_pd(-0.0);
+    const __m256d max_absolute_coordinates = _mm256_max_pd(
+        _mm256_max_pd(_mm256_andnot_pd(sign_mask, first_latitudes), _mm256_andnot_pd(sign_mask, first_longitudes)),
+        _mm256_max_pd(_mm256_andnot_pd(sign_mask, second_latitudes), _mm256_andnot_pd(sign_mask, second_longitudes))
+    );
+
+    // _mm256_max_pd() returns its second operand if either is NaN, so NaNs are checked separately
+    const __m256d is_nan = _mm256_or_pd(
+        _mm256_or_pd(_mm256_cmp_pd(first_latitudes, first_latitudes, _CMP_UNORD_Q), _mm256_cmp_pd(first_longitudes, first_longitudes, _CMP_UNORD_Q)),
+        _mm256_or_pd(_mm256_cmp_pd(second_latitudes, second_latitudes, _CMP_UNORD_Q), _mm256_cmp_pd(second_longitudes, second_longitudes, _CMP_UNORD_Q))
+    );
+
+    return _mm256_movemask_pd(_mm256_or_pd(is_nan, _mm256_cmp_pd(max_absolute_coordinates, _mm256_set1_pd(HAVERSINE_AVX2_MAX_ABSOLUTE_COORDINATE), _CMP_GT_OQ)));
+}
+
+HAVERSINE_AVX2 void haversine_one_to_many_avx2(
+    const double first_latitude,
+    const double first_longitude,
+    const double* second_latitudes,
+    const double* second_longitudes,
+    const size_t number_of_second_points,
+    double* distances
+) {
+    const __m256d first_latitudes = _mm256_set1_pd(first_latitude);
+    const __m256d first_longitudes = _mm256_set1_pd(first_longitude);
+    const __m256d cos_first_latitudes = haversine_avx2_cos(_mm256_mul_pd(first_latitudes, _mm256_set1_pd(DEGREES_TO_RADIANS)));
+
+    for (size_t i = 0; i < number_of_second_points; i += 4) {
+        const size_t number_of_lanes = (number_of_second_points - i < 4) ? (number_of_second_points - i) : 4;
+        const __m256i lane_mask = get_haversine_avx2_lane_mask(number_of_lanes);
+
+        const __m256d block_second_latitudes = _mm256_maskload_pd(second_latitudes + i, lane_mask);
+        const __m256d block_second_longitudes = _mm256_maskload_pd(second_longitudes + i, lane_mask);
+        const __m256d cos_second_latitudes = haversine_avx2_cos(_mm256_mul_pd(block_second_latitudes, _mm256_set1_pd(DEGREES_TO_RADIANS)));
+
+        _mm256_maskstore_pd(
+            distances + i,
+            lane_mask,
+            haversine_avx2(first_latitudes, first_longitudes, cos_first_latitudes, block_second_latitudes, block_second_longitudes, cos_second_latitudes)
+        );
+
+        int fallback_lanes = get_haversine_avx2_fallback_lanes(first_latitudes, first_longitudes, block_second_latitudes, block_second_longitudes) & ((1 << number_of_lanes) - 1);
+        for (; fallback_lanes; fallback_lanes &= fallback_lanes - 1) {
+            const size_t j = i + __builtin_ctz(fallback_lanes);
+            distances[j] = haversine(first_latitude, first_longitude, second_latitudes[j], second_longitudes[j]);
+        }
+    }
+}
+
+HAVERSINE_AVX2 void haversine_many_to_one_avx2(
+    const double* first_latitudes,
+    const double* first_longitudes,
+    const size_t number_of_first_points,
+    const double second_latitude,
+    const double second_longitude,
+    double* distances
+) {
+    const __m256d second_latitudes = _mm256_set1_pd(second_latitude);
+    const __m256d second_longitudes = _mm256_set1_pd(second_longitude);
+    const __m256d cos_second_latitudes = haversine_avx2_cos(_mm256_mul_pd(second_latitudes, _mm256_set1_pd(DEGREES_TO_RADIANS)));
+
+    for (size_t i = 0; i < number_of_first_points; i += 4) {
+        const size_t number_of_lanes = (number_of_first_points - i < 4) ? (number_of_first_points - i) : 4;
+        const __m256i lane_mask = get_haversine_avx2_lane_mask(number_of_lanes);
+
+        const __m256d block_first_latitudes = _mm256_maskload_pd(first_latitudes + i, lane_mask);
+        const __m256d block_first_longitudes = _mm256_maskload_pd(first_longitudes + i, lane_mask);
+        const __m256d cos_first_latitudes = haversine_avx2_cos(_mm256_mul_pd(block_first_latitudes, _mm256_set1_pd(DEGREES_TO_RADIANS)));
+
+        _mm256_maskstore_pd(
+            distances + i,
+            lane_mask,
+            haversine_avx2(block_first_latitudes, block_first_longitudes, cos_first_latitudes, second_latitudes, second_longitudes, cos_second_latitudes)
+        );
+
+        int fallback_lanes = get_haversine_avx2_fallback_lanes(block_first_latitudes, block_first_longitudes, second_latitudes, second_longitudes) & ((1 << number_of_lanes) - 1);
+        for (; fallback_lanes; fallback_lanes &= fallback_lanes - 1) {
+            const size_t j = i + __builtin_ctz(fallback_lanes);
+            distances[j] = haversine(first_latitudes[j], first_longitudes[j], second_latitude, second_longitude);
+        }
+    }
+}
+
+HAVERSINE_AVX2 void haversine_pairwise_avx2(
+    const double* first_latitudes,
+    const double* first_longitudes,
+    const double* second_latitudes,
+    const double* second_longitudes,
+    const size_t number_of_pairs,
+    double* distances
+) {
+    for (size_t i = 0; i < number_of_pairs; i += 4) {
+        const size_t number_of_lanes = (number_of_pairs - i < 4) ? (number_of_pairs - i) : 4;
+        const __m256i lane_mask = get_haversine_avx2_lane_mask(number_of_lanes);
+
+        const __m256d block_first_latitudes = _mm256_maskload_pd(first_latitudes + i, lane_mask);
+        const __m256d block_first_longitudes = _mm256_maskload_pd(first_longitudes + i, lane_mask);
+        const __m256d block_second_latitudes = _mm256_maskload_pd(second_latitudes + i, lane_mask);
+        const __m256d block_second_longitudes = _mm256_maskload_pd(second_longitudes + i, lane_mask);
+        const __m256d cos_first_latitudes = haversine_avx2_cos(_mm256_mul_pd(block_first_latitudes, _mm256_set1_pd(DEGREES_TO_RADIANS)));
+        const __m256d cos_second_latitudes = haversine_avx2_cos(_mm256_mul_pd(block_second_latitudes, _mm256_set1_pd(DEGREES_TO_RADIANS)));
+
+        _mm256_maskstore_pd(
+            distances + i,
+            lane_mask,
+            haversine_avx2(block_first_latitudes, block_first_longitudes, cos_first_latitudes, block_second_latitudes, block_second_longitudes, cos_second_latitudes)
+        );
+
+        int fallback_lanes = get_haversine_avx2_fallback_lanes(block_first_latitudes, block_first_longitudes, block_second_latitudes, block_second_longitudes) & ((1 << number_of_lanes) - 1);
+        for (; fallback_lanes; fallback_lanes &= fallback_lanes - 1) {
+            const size_t j = i + __builtin_ctz(fallback_lanes);
+            distances[j] = haversine(first_latitudes[j], first_longitudes[j], second_latitudes[j], second_longitudes[j]);
+        }
+    }
+}
+
+// whether haversine_pairwise_avx2() agrees with haversine_pairwise_scalar() on pairs of points spanning the globe,
+// to within a relative error of 1e-12 (the AVX2 kernels err by about 1e-15 except near antipodal points, where haversine() itself is ill-conditioned),
+// so that a build that breaks the vector functions (e.g., by reassociating their argument reduction) falls back to the scalar kernels
+bool check_haversine_avx2_kernels() {
+    const size_t number_of_pairs = 8;
+    const double first_latitudes[number_of_pairs] = { 0, 52.52, -33.87, 10, 45, 30, 89.9, -0.5 };
+    const double first_longitudes[number_of_pairs] = { 0, 13.40, 151.21, 170, 7, 100, 0, -179.5 };
+    const double second_latitudes[number_of_pairs] = { 0, 40.71, 35.68, 10, 45.0001, -20, -45, 0.5 };
+    const double second_longitudes[number_of_pairs] = { 0, -74.01, 139.69, -170, 7.0001, -50, 90, 179.5 };
+
+    double scalar_distances[number_of_pairs];
+    double avx2_distances[number_of_pairs];
+    haversine_pairwise_scalar(first_latitudes, first_longitudes, second_latitudes, second_longitudes, number_of_pairs, scalar_distances);
+    haversine_pairwise_avx2(first_latitudes, first_longitudes, second_latitudes, second_longitudes, number_of_pairs, avx2_distances);
+
+    for (size_t i = 0; i < number_of_pairs; ++i) {
+        if (!(fabs(avx2_distances[i] - scalar_distances[i]) <= 1e-12 * scalar_distances[i])) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+#endif
+
+// whether the batched kernels below run the AVX2 kernels, decided once at run time by the CPU and check_haversine_avx2_kernels()
+inline bool is_haversine_avx2_supported() {
+#ifdef HAVERSINE_HAS_AVX2_KERNELS
+    static const bool is_supported = __builtin_cpu_supports("avx2") && check_haversine_avx2_kernels();
+    return is_supported;
+#else
+    return false;
+#endif
+}
+
+// distances[i] = haversine(first_latitude, first_longitude, second_latitudes[i], second_longitudes[i]), on AVX2 if the CPU supports it
+void haversine_one_to_many(
+    const double first_latitude,
+    const double first_longitude,
+    const double* second_latitudes,
+    const double* second_longitudes,
+    const size_t number_of_second_points,
+    double* distances
+) {
+#ifdef HAVERSINE_HAS_AVX2_KERNELS
+    if (is_haversine_avx2_supported()) {
+        haversine_one_to_many_avx2(first_latitude, first_longitude, second_latitudes, second_longitudes, number_of_second_points, distances);
+        return;
+    }
+#endif
+
+    haversine_one_to_many_scalar(first_latitude, first_longitude, second_latitudes, second_longitudes, number_of_second_points, distances);
+}
+
+// distances[i] = haversine(first_latitudes[i], first_longitudes[i], second_latitude, second_longitude), on AVX2 if the CPU supports it
+void haversine_many_to_one(
+    const double* first_latitudes,
+    const double* first_longitudes,
+    const size_t number_of_first_points,
+    const double second_latitude,
+    const double second_longitude,
+    double* distances
+) {
+#ifdef HAVERSINE_HAS_AVX2_KERNELS
+    if (is_haversine_avx2_supported()) {
+        haversine_many_to_one_avx2(first_latitudes, first_longitudes, number_of_first_points, second_latitude, second_longitude, distances);
+        return;
+    }
+#endif
+
+    haversine_many_to_one_scalar(first_latitudes, first_longitudes, number_of_first_points, second_latitude, second_longitude, distances);
+}
+
+// distances[i] = haversine(first_latitudes[i], first_longitudes[i], second_latitudes[i], second_longitudes[i]), on AVX2 if the CPU supports it
+void haversine_pairwise(
+    const double* first_latitudes,
+    const double* first_longitudes,
+    const double* second_latitudes,
+    const double* second_longitudes,
+    const size_t number_of_pairs,
+    double* distances
+) {
+#ifdef HAVERSINE_HAS_AVX2_KERNELS
+    if (is_haversine_avx2_supported()) {
+        haversine_pairwise_avx2(first_latitudes, first_longitudes, second_latitudes, second_longitudes, number_of_pairs, distances);
+        return;
+    }
+#endif
+
+    haversine_pairwise_scalar(first_latitudes, first_longitudes, second_latitudes, second_longitudes, number_of_pairs, distances);
+}
+
 #endif
@@ -1,16 +1,23 @@
 #ifndef IS_EDGE_DESCRIPTOR_IN_EDGE_SET_HPP
 #define IS_EDGE_DESCRIPTOR_IN_EDGE_SET_HPP
 
-template <typename EdgeSet> struct IsEdgeDescriptorInEdgeSet {
+#include <boost/property_map/property_map.hpp>
+
+
+// EdgeSet is indexed by edge index (e.g., a std::vector<bool> with an element for each edge, see assign_edge_indices.hpp),
+// and EdgeIndexMap maps edge descriptors to their indices, e.g., boost::get(boost::edge_index, graph).
+template <typename EdgeSet, typename EdgeIndexMap> struct IsEdgeDescriptorInEdgeSet {
     EdgeSet* edge_set_pointer;
+    EdgeIndexMap edge_index_map;
     
-    IsEdgeDescriptorInEdgeSet(): edge_set_pointer(nullptr) { }
-    IsEdgeDescriptorInEdgeSet(EdgeSet* t_edge_set_pointer): edge_set_pointer(t_edge_set_pointer) { }
+    IsEdgeDescriptorInEdgeSet(): edge_set_pointer(nullptr), edge_index_map() { }
+    IsEdgeDescriptorInEdgeSet(EdgeSet* t_edge_set_pointer, EdgeIndexMap t_edge_index_map):
+        edge_set_pointer(t_edge_set_pointer),
+        edge_index_map(t_edge_index_map) { }
     
     template <typename EdgeDescriptor> bool operator()(const EdgeDescriptor& edge_descriptor) const {
-        return edge_set_pointer->count(edge_descriptor);
+        return (*edge_set_pointer)[boost::get(edge_index_map, edge_descriptor)];
     }
 };
 
 # endif
-
@@ -1,18 +1,34 @@
 #ifndef LOAD_TRAJECTORY_DATASET_HPP
 #define LOAD_TRAJECTORY_DATASET_HPP
 
+#include <stddef.h>
 #include <time.h>
 
 #include <string>
 
+#include <boost/unordered_map.hpp>
 #include <csv.h>
 
+#include "trajectory.h"
+#include "trajectory_store.hpp"
+#include "trajectory_store_file.hpp"
 
-// load trajectory dataset in the form of a string to trajectory map
+
+// load trajectory dataset in the form of a string to trajectory map, from a CSV file or a trajectory file
 template <typename StringToTrajectoryMap> void load_trajectory_dataset(
     const std::string& trajectory_dataset_path,
     StringToTrajectoryMap& trajectory_dataset
 ) {
+    if (is_trajectory_store_file(trajectory_dataset_path)) {
+        const TrajectoryStoreFile trajectory_store_file(trajectory_dataset_path);
+
+        for (size_t user = 0; user < trajectory_store_file.number_of_users; ++user) {
+            trajectory_dataset[std::string(trajectory_store_file.get_user_name(user))] = trajectory_store_file.get_trajectory(user);
+        }
+
+        return;
+    }
+
     io::CSVReader<4> in(trajectory_dataset_path);
     in.read_header(io::ignore_extra_column, "user", "latitude", "longitude", "timestamp");
     
@@ -28,12 +44,29 @@ template <typename StringToTrajectoryMap> void load_trajectory_dataset(
     }
 }
 
-// load trajectory dataset in the form of a vertex descriptor to trajectory map
+// load trajectory dataset in the form of a vertex descriptor to trajectory map, from a CSV file or a trajectory file
 template <typename StringToVertexDescriptorMap, typename VertexDescriptorToTrajectoryMap> void load_trajectory_dataset(
     const StringToVertexDescriptorMap& string_to_vertex_descriptor_map,
     const std::string& trajectory_dataset_path,
     VertexDescriptorToTrajectoryMap& trajectory_dataset
 ) {
+    if (is_trajectory_store_file(trajectory_dataset_path)) {
+        const TrajectoryStoreFile trajectory_store_file(trajectory_dataset_path);
+
+        std::string user;
+        for (size_t user_index = 0; user_index < trajectory_store_file.number_of_users; ++user_index) {
+            user = trajectory_store_file.get_user_name(user_index);
+
+            if (string_to_vertex_descriptor_map.count(user)) {
+                trajectory_dataset[
+                    string_to_vertex_descriptor_map.at(user)
+                ] = trajectory_store_file.get_trajectory(user_index);
+            }
+        }
+
+        return;
+    }
+
     io::CSVReader<4> in(trajectory_dataset_path);
     in.read_header(io::ignore_extra_column, "user", "latitude", "longitude", "timestamp");
     
@@ -53,5 +86,26 @@ template <typename StringToVertexDescriptorMap, typename VertexDescriptorToTraje
     }
 }
 
+// load trajectory dataset in the form of a TrajectoryStore indexed by vertex descriptor,
+// mapping a trajectory file without copying any points, or reading a CSV file
+template <typename StringToVertexDescriptorMap> TrajectoryStore load_trajectory_store(
+    const StringToVertexDescriptorMap& string_to_vertex_descriptor_map,
+    const size_t number_of_vertices,
+    const std::string& trajectory_dataset_path
+) {
+    if (is_trajectory_store_file(trajectory_dataset_path)) {
+        return map_trajectory_store_file(string_to_vertex_descriptor_map, number_of_vertices, trajectory_dataset_path);
+    }
+
+    boost::unordered_map<size_t, Trajectory> vertex_descriptor_to_trajectory_map;
+    load_trajectory_dataset(
+        string_to_vertex_descriptor_map,
+        trajectory_dataset_path,
+        vertex_descriptor_to_trajectory_map
+    );
+
+    return TrajectoryStore(number_of_vertices, vertex_descriptor_to_trajectory_map);
+}
+
 #endif
 
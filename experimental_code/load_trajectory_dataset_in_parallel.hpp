@@ -0,0 +1,482 @@
+#ifndef LOAD_TRAJECTORY_DATASET_IN_PARALLEL_HPP
+#define LOAD_TRAJECTORY_DATASET_IN_PARALLEL_HPP
+
+#include <math.h>
+#include <stddef.h>
+#include <string.h>
+#include <time.h>
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <boost/asio/post.hpp>
+#include <boost/asio/thread_pool.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/unordered_map.hpp>
+
+#include "haversine.hpp"
+#include "load_trajectory_dataset.hpp"
+#include "trajectory.h"
+#include "trajectory_store.hpp"
+
+
+// The trajectories in a CSV file grouped by user, with users in order of first appearance
+// and the points of user i in [offsets[i], offsets[i + 1]) of each column, in file order (as load_trajectory_dataset() reads them).
+struct ParsedTrajectoryDataset {
+    std::vector<std::string> user_names;
+    std::vector<size_t> offsets;
+    std::vector<double> latitudes;
+    std::vector<double> longitudes;
+    std::vector<double> cos_latitudes;
+    std::vector<time_t> timestamps;
+
+    Trajectory get_trajectory(const size_t user) const {
+        Trajectory trajectory;
+        trajectory.reserve(offsets[user + 1] - offsets[user]);
+
+        for (size_t position = offsets[user]; position < offsets[user + 1]; ++position) {
+            trajectory.push_back({ latitudes[position], longitudes[position], timestamps[position] });
+        }
+
+        return trajectory;
+    }
+};
+
+
+// the same as io::detail::parse_float() of csv.h on [begin, end), so that both loaders produce bitwise identical coordinates
+inline double parse_trajectory_dataset_float(const char* begin, const char* end) {
+    const char* position = begin;
+
+    bool is_negative = false;
+    if (position != end && *position == '-') {
+        is_negative = true;
+        ++position;
+    }
+    else if (position != end && *position == '+') {
+        ++position;
+    }
+
+    double x = 0;
+    while (position != end && '0' <= *position && *position <= '9') {
+        const int digit = *position - '0';
+        x *= 10;
+        x += digit;
+        ++position;
+    }
+
+    if (position != end && (*position == '.' || *position == ',')) {
+        ++position;
+
+        double place_value = 1;
+        while (position != end && '0' <= *position && *position <= '9') {
+            place_value /= 10;
+            const int digit = *position - '0';
+            ++position;
+            x += digit * place_value;
+        }
+    }
+
+    if (position != end && (*position == 'e' || *position == 'E')) {
+        ++position;
+
+        bool is_negative_exponent = false;
+        if (position != end && *position == '-') {
+            is_negative_exponent = true;
+            ++position;
+        }
+        else if (position != end && *position == '+') {
+            ++position;
+        }
+
+        int exponent = 0;
+        while (position != end && '0' <= *position && *position <= '9') {
+            exponent = std::min(exponent * 10 + (*position - '0'), 100000);
+            ++position;
+        }
+        if (is_negative_exponent) exponent = -exponent;
+
+        if (exponent != 0) {
+            double base;
+            if (exponent < 0) {
+                base = 0.1;
+                exponent = -exponent;
+            }
+            else {
+                base = 10;
+            }
+
+            while (exponent != 1) {
+                if ((exponent & 1) == 0) {
+                    base = base * base;
+                    exponent >>= 1;
+                }
+                else {
+                    x *= base;
+                    --exponent;
+                }
+            }
+            x *= base;
+        }
+    }
+
+    if (position != end) {
+        throw std::runtime_error("parse_trajectory_dataset_float: invalid number " + std::string(begin, end));
+    }
+
+    if (is_negative) x = -x;
+
+    return x;
+}
+
+// the same as io::detail::parse() of csv.h for signed integers on [begin, end), throwing on overflow
+inline time_t parse_trajectory_dataset_integer(const char* begin, const char* end) {
+    const char* position = begin;
+
+    bool is_negative = false;
+    if (position != end && *position == '-') {
+        is_negative = true;
+        ++position;
+    }
+    else if (position != end && *position == '+') {
+        ++position;
+    }
+
+    time_t x = 0;
+    for (; position != end; ++position) {
+        if (*position < '0' || *position > '9') {
+            throw std::runtime_error("parse_trajectory_dataset_integer: invalid number " + std::string(begin, end));
+        }
+
+        const time_t digit = *position - '0';
+        if (is_negative ? (x < (std::numeric_limits<time_t>::min() + digit) / 10) : (x > (std::numeric_limits<time_t>::max() - digit) / 10)) {
+            throw std::runtime_error("parse_trajectory_dataset_integer: number out of range " + std::string(begin, end));
+        }
+
+        x = is_negative ? 10 * x - digit : 10 * x + digit;
+    }
+
+    return x;
+}
+
+// the fields of the line [begin, end) without a trailing '\r', split at commas and trimmed of spaces and tabs like csv.h does
+inline void split_trajectory_dataset_line(
+    const char* begin,
+    const char* end,
+    std::vector<std::pair<const char*, const char*>>& fields
+) {
+    fields.clear();
+
+    if (begin != end && end[-1] == '\r') --end;
+
+    const char* field_begin = begin;
+    while (true) {
+        const char* field_end = field_begin;
+        while (field_end != end && *field_end != ',') ++field_end;
+
+        const char* trimmed_begin = field_begin;
+        const char* trimmed_end = field_end;
+        while (trimmed_begin != trimmed_end && (*trimmed_begin == ' ' || *trimmed_begin == '\t')) ++trimmed_begin;
+        while (trimmed_begin != trimmed_end && (trimmed_end[-1] == ' ' || trimmed_end[-1] == '\t')) --trimmed_end;
+        fields.emplace_back(trimmed_begin, trimmed_end);
+
+        if (field_end == end) break;
+        field_begin = field_end + 1;
+    }
+}
+
+
+// Parses the CSV file at trajectory_dataset_path (with columns user, latitude, longitude, and timestamp, in any order) like load_trajectory_dataset().
+// The file is mapped into memory and split at line boundaries into chunks, each of which is parsed by a thread into its own columns,
+// with the users of the chunk interned as views into the mapping.
+// The chunks are then merged by a stable counting sort by user, which keeps the points of each user in file order.
+inline ParsedTrajectoryDataset parse_trajectory_dataset_in_parallel(
+    const std::string& trajectory_dataset_path,
+    const size_t number_of_threads
+) {
+    boost::interprocess::file_mapping file_mapping(trajectory_dataset_path.c_str(), boost::interprocess::read_only);
+    boost::interprocess::mapped_region mapped_region(file_mapping, boost::interprocess::read_only);
+
+    const char* const file_begin = static_cast<const char*>(mapped_region.get_address());
+    const char* const file_end = file_begin + mapped_region.get_size();
+
+    // find the columns in the header
+    const char* const header_end = std::find(file_begin, file_end, '\n');
+    const char* const body_begin = header_end == file_end ? file_end : header_end + 1;
+
+    std::vector<std::pair<const char*, const char*>> fields;
+    split_trajectory_dataset_line(file_begin, header_end, fields);
+
+    const char* const column_names[] = { "user", "latitude", "longitude", "timestamp" };
+    size_t column_indices[4];
+    for (size_t column = 0; column < 4; ++column) {
+        size_t field = 0;
+        while (field < fields.size() && std::string_view(fields[field].first, fields[field].second - fields[field].first) != column_names[column]) ++field;
+
+        if (field == fields.size()) {
+            throw std::runtime_error("parse_trajectory_dataset_in_parallel: missing column " + std::string(column_names[column]) + " in " + trajectory_dataset_path);
+        }
+
+        column_indices[column] = field;
+    }
+
+    const size_t number_of_fields = 1 + *std::max_element(column_indices, column_indices + 4);
+
+    // split the body into chunks ending right after a newline (or at the end of the file)
+    const size_t number_of_chunks = std::max<size_t>(1, number_of_threads * 4);
+    const size_t body_size = file_end - body_begin;
+
+    std::vector<const char*> chunk_boundaries { body_begin };
+    for (size_t chunk_index = 1; chunk_index < number_of_chunks; ++chunk_index) {
+        const char* boundary = std::max(body_begin + body_size * chunk_index / number_of_chunks, chunk_boundaries.back());
+        boundary = std::find(boundary, file_end, '\n');
+        if (boundary != file_end) ++boundary;
+
+        if (boundary != chunk_boundaries.back()) chunk_boundaries.push_back(boundary);
+    }
+    if (chunk_boundaries.back() != file_end) chunk_boundaries.push_back(file_end);
+
+    // parse each chunk into its own columns
+    struct Chunk {
+        std::vector<std::string_view> user_names;
+        std::vector<size_t> user_counts;
+        std::vector<size_t> user_indices;
+        std::vector<double> latitudes;
+        std::vector<double> longitudes;
+        std::vector<time_t> timestamps;
+        std::string error;
+    };
+    std::vector<Chunk> chunks(chunk_boundaries.size() - 1);
+
+    boost::asio::thread_pool thread_pool(number_of_threads);
+
+    for (size_t chunk_index = 0; chunk_index < chunks.size(); ++chunk_index) {
+        boost::asio::post(
+            thread_pool,
+            [&chunks, &chunk_boundaries, &column_indices, number_of_fields, chunk_index]() {
+                Chunk& chunk = chunks[chunk_index];
+                boost::unordered_map<std::string_view, size_t> user_name_to_index_map;
+                std::vector<std::pair<const char*, const char*>> fields;
+
+                try {
+                    const char* line_begin = chunk_boundaries[chunk_index];
+                    const char* const chunk_end = chunk_boundaries[chunk_index + 1];
+
+                    while (line_begin != chunk_end) {
+                        const char* const line_end = std::find(line_begin, chunk_end, '\n');
+                        const char* const next_line_begin = line_end == chunk_end ? chunk_end : line_end + 1;
+
+                        // empty lines are skipped
+                        if (line_begin == line_end || (line_end - line_begin == 1 && *line_begin == '\r')) {
+                            line_begin = next_line_begin;
+                            continue;
+                        }
+
+                        split_trajectory_dataset_line(line_begin, line_end, fields);
+                        if (fields.size() < number_of_fields) {
+                            throw std::runtime_error("parse_trajectory_dataset_in_parallel: too few columns in line " + std::string(line_begin, line_end));
+                        }
+
+                        const auto& user_field = fields[column_indices[0]];
+                        const auto iterator_and_is_inserted = user_name_to_index_map.emplace(
+                            std::string_view(user_field.first, user_field.second - user_field.first),
+                            chunk.user_names.size()
+                        );
+                        if (iterator_and_is_inserted.second) {
+                            chunk.user_names.push_back(iterator_and_is_inserted.first->first);
+                            chunk.user_counts.push_back(0);
+                        }
+
+                        const size_t user_index = iterator_and_is_inserted.first->second;
+                        chunk.user_indices.push_back(user_index);
+                        ++chunk.user_counts[user_index];
+
+                        chunk.latitudes.push_back(parse_trajectory_dataset_float(fields[column_indices[1]].first, fields[column_indices[1]].second));
+                        chunk.longitudes.push_back(parse_trajectory_dataset_float(fields[column_indices[2]].first, fields[column_indices[2]].second));
+                        chunk.timestamps.push_back(parse_trajectory_dataset_integer(fields[column_indices[3]].first, fields[column_indices[3]].second));
+
+                        line_begin = next_line_begin;
+                    }
+                }
+                catch (const std::runtime_error& e) {
+                    chunk.error = e.what();
+                }
+            }
+        );
+    }
+
+    thread_pool.join();
+
+    for (const Chunk& chunk: chunks) {
+        if (!chunk.error.empty()) throw std::runtime_error(chunk.error);
+    }
+
+    // intern the users of all chunks in order of first appearance, and find where the points of each user in each chunk go
+    ParsedTrajectoryDataset parsed_trajectory_dataset;
+    boost::unordered_map<std::string_view, size_t> user_name_to_index_map;
+    std::vector<std::vector<size_t>> chunk_user_index_to_user_index_maps(chunks.size());
+    std::vector<size_t> user_counts;
+
+    for (size_t chunk_index = 0; chunk_index < chunks.size(); ++chunk_index) {
+        const Chunk& chunk = chunks[chunk_index];
+        std::vector<size_t>& chunk_user_index_to_user_index_map = chunk_user_index_to_user_index_maps[chunk_index];
+
+        for (size_t chunk_user_index = 0; chunk_user_index < chunk.user_names.size(); ++chunk_user_index) {
+            const auto iterator_and_is_inserted = user_name_to_index_map.emplace(
+                chunk.user_names[chunk_user_index],
+                parsed_trajectory_dataset.user_names.size()
+            );
+            if (iterator_and_is_inserted.second) {
+                parsed_trajectory_dataset.user_names.emplace_back(chunk.user_names[chunk_user_index]);
+                user_counts.push_back(0);
+            }
+
+            chunk_user_index_to_user_index_map.push_back(iterator_and_is_inserted.first->second);
+            user_counts[iterator_and_is_inserted.first->second] += chunk.user_counts[chunk_user_index];
+        }
+    }
+
+    const size_t number_of_users = parsed_trajectory_dataset.user_names.size();
+
+    parsed_trajectory_dataset.offsets.assign(number_of_users + 1, 0);
+    for (size_t user_index = 0; user_index < number_of_users; ++user_index) {
+        parsed_trajectory_dataset.offsets[user_index + 1] = parsed_trajectory_dataset.offsets[user_index] + user_counts[user_index];
+    }
+
+    // the first position of the points of each user of each chunk, after those of the same user in earlier chunks
+    std::vector<std::vector<size_t>> chunk_user_positions(chunks.size());
+    std::vector<size_t> next_positions(parsed_trajectory_dataset.offsets.begin(), parsed_trajectory_dataset.offsets.end() - 1);
+
+    for (size_t chunk_index = 0; chunk_index < chunks.size(); ++chunk_index) {
+        for (size_t chunk_user_index = 0; chunk_user_index < chunks[chunk_index].user_names.size(); ++chunk_user_index) {
+            const size_t user_index = chunk_user_index_to_user_index_maps[chunk_index][chunk_user_index];
+
+            chunk_user_positions[chunk_index].push_back(next_positions[user_index]);
+            next_positions[user_index] += chunks[chunk_index].user_counts[chunk_user_index];
+        }
+    }
+
+    // scatter the points of each chunk into place
+    const size_t number_of_points = parsed_trajectory_dataset.offsets[number_of_users];
+    parsed_trajectory_dataset.latitudes.resize(number_of_points);
+    parsed_trajectory_dataset.longitudes.resize(number_of_points);
+    parsed_trajectory_dataset.cos_latitudes.resize(number_of_points);
+    parsed_trajectory_dataset.timestamps.resize(number_of_points);
+
+    boost::asio::thread_pool scatter_thread_pool(number_of_threads);
+
+    for (size_t chunk_index = 0; chunk_index < chunks.size(); ++chunk_index) {
+        boost::asio::post(
+            scatter_thread_pool,
+            [&parsed_trajectory_dataset, &chunks, &chunk_user_positions, chunk_index]() {
+                const Chunk& chunk = chunks[chunk_index];
+                std::vector<size_t>& positions = chunk_user_positions[chunk_index];
+
+                for (size_t row = 0; row < chunk.user_indices.size(); ++row) {
+                    const size_t position = positions[chunk.user_indices[row]]++;
+
+                    parsed_trajectory_dataset.latitudes[position] = chunk.latitudes[row];
+                    parsed_trajectory_dataset.longitudes[position] = chunk.longitudes[row];
+                    parsed_trajectory_dataset.cos_latitudes[position] = cos(chunk.latitudes[row] * DEGREES_TO_RADIANS);
+                    parsed_trajectory_dataset.timestamps[position] = chunk.timestamps[row];
+                }
+            }
+        );
+    }
+
+    scatter_thread_pool.join();
+
+    return parsed_trajectory_dataset;
+}
+
+
+// load_trajectory_dataset() for a string to trajectory map, parsing CSV files in parallel
+template <typename StringToTrajectoryMap> void load_trajectory_dataset_in_parallel(
+    const std::string& trajectory_dataset_path,
+    StringToTrajectoryMap& trajectory_dataset,
+    const size_t number_of_threads
+) {
+    if (is_trajectory_store_file(trajectory_dataset_path)) {
+        load_trajectory_dataset(trajectory_dataset_path, trajectory_dataset);
+        return;
+    }
+
+    const ParsedTrajectoryDataset parsed_trajectory_dataset = parse_trajectory_dataset_in_parallel(trajectory_dataset_path, number_of_threads);
+
+    for (size_t user_index = 0; user_index < parsed_trajectory_dataset.user_names.size(); ++user_index) {
+        trajectory_dataset[parsed_trajectory_dataset.user_names[user_index]] = parsed_trajectory_dataset.get_trajectory(user_index);
+    }
+}
+
+// load_trajectory_dataset() for a vertex descriptor to trajectory map, parsing CSV files in parallel
+template <typename StringToVertexDescriptorMap, typename VertexDescriptorToTrajectoryMap> void load_trajectory_dataset_in_parallel(
+    const StringToVertexDescriptorMap& string_to_vertex_descriptor_map,
+    const std::string& trajectory_dataset_path,
+    VertexDescriptorToTrajectoryMap& trajectory_dataset,
+    const size_t number_of_threads
+) {
+    if (is_trajectory_store_file(trajectory_dataset_path)) {
+        load_trajectory_dataset(string_to_vertex_descriptor_map, trajectory_dataset_path, trajectory_dataset);
+        return;
+    }
+
+    const ParsedTrajectoryDataset parsed_trajectory_dataset = parse_trajectory_dataset_in_parallel(trajectory_dataset_path, number_of_threads);
+
+    for (size_t user_index = 0; user_index < parsed_trajectory_dataset.user_names.size(); ++user_index) {
+        const std::string& user = parsed_trajectory_dataset.user_names[user_index];
+
+        if (string_to_vertex_descriptor_map.count(user)) {
+            trajectory_dataset[
+                string_to_vertex_descriptor_map.at(user)
+            ] = parsed_trajectory_dataset.get_trajectory(user_index);
+        }
+    }
+}
+
+// load_trajectory_store(), parsing CSV files in parallel straight into the columns of the TrajectoryStore
+template <typename StringToVertexDescriptorMap> TrajectoryStore load_trajectory_store_in_parallel(
+    const StringToVertexDescriptorMap& string_to_vertex_descriptor_map,
+    const size_t number_of_vertices,
+    const std::string& trajectory_dataset_path,
+    const size_t number_of_threads
+) {
+    if (is_trajectory_store_file(trajectory_dataset_path)) {
+        return map_trajectory_store_file(string_to_vertex_descriptor_map, number_of_vertices, trajectory_dataset_path);
+    }
+
+    ParsedTrajectoryDataset parsed_trajectory_dataset = parse_trajectory_dataset_in_parallel(trajectory_dataset_path, number_of_threads);
+
+    TrajectoryStore trajectory_store;
+    trajectory_store.begins.assign(number_of_vertices, 0);
+    trajectory_store.ends.assign(number_of_vertices, 0);
+
+    for (size_t user_index = 0; user_index < parsed_trajectory_dataset.user_names.size(); ++user_index) {
+        const auto iterator = string_to_vertex_descriptor_map.find(parsed_trajectory_dataset.user_names[user_index]);
+        if (iterator == string_to_vertex_descriptor_map.end()) continue;
+
+        trajectory_store.begins[iterator->second] = parsed_trajectory_dataset.offsets[user_index];
+        trajectory_store.ends[iterator->second] = parsed_trajectory_dataset.offsets[user_index + 1];
+    }
+
+    std::shared_ptr<TrajectoryStore::Columns> columns = std::make_shared<TrajectoryStore::Columns>();
+    columns->latitudes = std::move(parsed_trajectory_dataset.latitudes);
+    columns->longitudes = std::move(parsed_trajectory_dataset.longitudes);
+    columns->cos_latitudes = std::move(parsed_trajectory_dataset.cos_latitudes);
+    columns->timestamps = std::move(parsed_trajectory_dataset.timestamps);
+
+    trajectory_store.latitudes = columns->latitudes.data();
+    trajectory_store.longitudes = columns->longitudes.data();
+    trajectory_store.cos_latitudes = columns->cos_latitudes.data();
+    trajectory_store.timestamps = columns->timestamps.data();
+    trajectory_store.storage = std::move(columns);
+
+    return trajectory_store;
+}
+
+#endif
@@ -18,6 +18,7 @@
 #include "read_adjacency_list.hpp"
 #include "trajectory.h"
 #include "trajectory_similarity.hpp"
+#include "vertex_indexed_trajectory_dataset.hpp"
 #include "write_vector.hpp"
 
 
@@ -127,11 +128,10 @@ int main(int argc, const char* argv[]) {
     Graph social_network;
     boost::unordered_map<std::string, VertexDescriptor> string_to_vertex_descriptor_map;
     
-    std::ifstream input_file_stream(input_graph_path);
     read_adjacency_list<boost::vertex_name_t>(
         social_network,
         string_to_vertex_descriptor_map,
-        input_file_stream
+        input_graph_path
     );
     
     const auto get_vertex_name = [&social_network](const VertexDescriptor& vertex_descriptor) {
@@ -144,7 +144,7 @@ int main(int argc, const char* argv[]) {
     std::vector<EdgeDescriptor> edges(edge_begin, edge_end);
     
     // load trajectory_dataset
-    boost::unordered_map<VertexDescriptor, Trajectory> trajectory_dataset;
+    VertexIndexedTrajectoryDataset trajectory_dataset(boost::num_vertices(social_network));
     
     load_trajectory_dataset(
         string_to_vertex_descriptor_map,
@@ -180,8 +180,8 @@ int main(int argc, const char* argv[]) {
             double similarity = trajectory_similarity(
                 trajectory_dataset.at(source),
                 trajectory_dataset.at(target),
-                tau,
                 delta,
+                tau,
                 [&spatial_distances, &temporal_distances](const Point& source_point, const Point& target_point) {
                     const double spatial_distance = haversine(
                         source_point.latitude,
@@ -0,0 +1,110 @@
+#ifndef MULTI_SOURCE_BREADTH_FIRST_SEARCH_HPP
+#define MULTI_SOURCE_BREADTH_FIRST_SEARCH_HPP
+
+/**
+ * https://doi.org/10.14778/2735496.2735507 (MS-BFS: The More the Merrier: Efficient Multi-Source Graph Traversal)
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <vector>
+
+
+// The number of sources one sweep of multi_source_breadth_first_search() traverses from, one per bit of a word.
+const size_t NUMBER_OF_SOURCES_PER_SWEEP = 64;
+
+
+// The per-vertex words and frontier lists of multi_source_breadth_first_search(), reused across sweeps over graphs
+// of at most number_of_vertices vertices, as allocating them for each sweep costs as much as a sweep over a small graph.
+struct MultiSourceBreadthFirstSearchBuffers {
+    std::vector<uint64_t> seen;
+    std::vector<uint64_t> frontier;
+    std::vector<uint64_t> next_frontier;
+    std::vector<uint32_t> frontier_vertices;
+    std::vector<uint32_t> next_frontier_vertices;
+
+    // zeroes the words of the vertices [0, number_of_vertices), growing them if needed
+    // (a finished sweep leaves frontier and next_frontier all zero, so only seen is refilled)
+    void reset(const size_t number_of_vertices) {
+        if (seen.size() < number_of_vertices) {
+            seen.resize(number_of_vertices);
+            frontier.resize(number_of_vertices);
+            next_frontier.resize(number_of_vertices);
+        }
+
+        std::fill(seen.begin(), seen.begin() + number_of_vertices, 0);
+        frontier_vertices.clear();
+        next_frontier_vertices.clear();
+    }
+};
+
+
+// Breadth-first searches from up to NUMBER_OF_SOURCES_PER_SWEEP sources at once over a graph with vertices [0, number_of_vertices)
+// in CSR form, i.e., the neighbors of vertex v are neighbors[offsets[v]], ..., neighbors[offsets[v + 1] - 1].
+// Bit i of a vertex's words stands for sources[i]:
+//     seen[v]              the sources that have reached v
+//     frontier[v]          the sources that reached v at the current level, which expand to the neighbors of v at the next one
+// so each edge is scanned once per level for all sources, instead of once per source.
+// Calls visit(vertex, reached_sources, distance) once for each vertex and distance at which some sources reach the vertex first,
+// where bit i of reached_sources is set if sources[i] is at that distance from vertex (the sources themselves are not visited).
+// number_of_sources must be at most NUMBER_OF_SOURCES_PER_SWEEP.
+template <typename Visitor> void multi_source_breadth_first_search(
+    const size_t number_of_vertices,
+    const uint64_t* offsets,
+    const uint32_t* neighbors,
+    const uint32_t* sources,
+    const size_t number_of_sources,
+    MultiSourceBreadthFirstSearchBuffers& buffers,
+    const Visitor& visit
+) {
+    buffers.reset(number_of_vertices);
+
+    uint64_t* seen = buffers.seen.data();
+    uint64_t* frontier = buffers.frontier.data();
+    uint64_t* next_frontier = buffers.next_frontier.data();
+
+    for (size_t source_index = 0; source_index < number_of_sources; ++source_index) {
+        const uint32_t source = sources[source_index];
+
+        if (!frontier[source]) {
+            buffers.frontier_vertices.push_back(source);
+        }
+        seen[source] |= uint64_t(1) << source_index;
+        frontier[source] |= uint64_t(1) << source_index;
+    }
+
+    for (size_t distance = 1; !buffers.frontier_vertices.empty(); ++distance) {
+        // expand the frontier to the neighbors that have not yet been reached by the same sources
+        for (const uint32_t vertex: buffers.frontier_vertices) {
+            const uint64_t vertex_frontier = frontier[vertex];
+
+            for (uint64_t position = offsets[vertex]; position < offsets[vertex + 1]; ++position) {
+                const uint32_t adjacent_vertex = neighbors[position];
+                const uint64_t newly_reached_sources = vertex_frontier & ~seen[adjacent_vertex];
+
+                if (newly_reached_sources) {
+                    if (!next_frontier[adjacent_vertex]) {
+                        buffers.next_frontier_vertices.push_back(adjacent_vertex);
+                    }
+                    next_frontier[adjacent_vertex] |= newly_reached_sources;
+                }
+            }
+
+            frontier[vertex] = 0;
+        }
+
+        // mark the newly reached sources as seen once per reached vertex rather than once per scanned edge
+        for (const uint32_t vertex: buffers.next_frontier_vertices) {
+            seen[vertex] |= next_frontier[vertex];
+            visit(vertex, next_frontier[vertex], distance);
+        }
+
+        std::swap(frontier, next_frontier);
+        buffers.frontier_vertices.swap(buffers.next_frontier_vertices);
+        buffers.next_frontier_vertices.clear();
+    }
+}
+
+#endif
@@ -0,0 +1,31 @@
+#ifndef PARSE_COMMA_SEPARATED_VALUES_HPP
+#define PARSE_COMMA_SEPARATED_VALUES_HPP
+
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+
+// parses a list of values such as "4,6,8" into a vector
+// throws std::runtime_error if a value cannot be parsed
+template <typename T> std::vector<T> parse_comma_separated_values(const std::string& comma_separated_values) {
+    std::vector<T> values;
+    
+    std::istringstream input_string_stream(comma_separated_values);
+    std::string token;
+    while (std::getline(input_string_stream, token, ',')) {
+        std::istringstream token_input_string_stream(token);
+        T value;
+        
+        if (!(token_input_string_stream >> value) || !(token_input_string_stream >> std::ws).eof()) {
+            throw std::runtime_error("invalid value in comma separated list: " + token);
+        }
+        
+        values.push_back(value);
+    }
+    
+    return values;
+}
+
+#endif
@@ -0,0 +1,170 @@
+// install the following c++ package
+// https://github.com/p-ranav/argparse
+// compile with -std=c++17
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <argparse/argparse.hpp>
+#include <boost/graph/adjacency_list.hpp>
+#include <boost/property_map/property_map.hpp>
+#include <boost/unordered_map.hpp>
+
+// csr_graph.hpp declares the Boost Graph Library functions for CSRGraph, so it precedes the algorithms calling them
+#include "csr_graph.hpp"
+#include "calculate_core_number.hpp"
+#include "calculate_core_number_in_flat_arrays.hpp"
+#include "calculate_core_number_in_parallel.hpp"
+#include "profile.hpp"
+#include "read_adjacency_list.hpp"
+#include "write_vector.hpp"
+
+
+// Graph typedefs
+typedef boost::adjacency_list<
+    boost::vecS,
+    boost::vecS,
+    boost::undirectedS,
+    boost::property<boost::vertex_name_t, std::string>
+> Graph;
+typedef boost::graph_traits<Graph>::vertex_descriptor VertexDescriptor;
+
+
+void parse_command_line_arguments(
+    int argc,
+    const char** argv,
+    std::string& input_graph_path,
+    std::string& output_path,
+    unsigned int& number_of_threads
+) {
+    // To start parsing command-line arguments, create an ArgumentParser
+    argparse::ArgumentParser parser("");
+
+    parser.add_argument("-g", "--graph")
+        .required()
+        .help("specify the input graph (an adjacency list or a CSR graph file)");
+
+    parser.add_argument("-o", "--output")
+        .required()
+        .help("specify the output file");
+
+    parser.add_argument("--threads")
+        .default_value<unsigned int>(1)
+        .scan<'u', unsigned int>()
+        .help("the number of threads of calculate_core_number_in_parallel()");
+
+    // Parse arguments
+    try {
+        parser.parse_args(argc, argv);
+    }
+    catch (const std::runtime_error& e) {
+        std::cerr << e.what() << '\n';
+        // std::cout << program prints a help message, including the program usage and information about the arguments registered with the ArgumentParser.
+        std::cerr << parser;
+        exit(EXIT_FAILURE);
+    }
+
+    // Use arguments
+    input_graph_path = parser.get<std::string>("--graph");
+    output_path = parser.get<std::string>("--output");
+    number_of_threads = std::max(parser.get<unsigned int>("--threads"), 1u);
+}
+
+
+int main(int argc, const char* argv[]) {
+    // parse command line arguments
+    std::string input_graph_path;
+    std::string output_path;
+    unsigned int number_of_threads;
+
+    parse_command_line_arguments(
+        argc,
+        argv,
+        input_graph_path,
+        output_path,
+        number_of_threads
+    );
+
+    // load social network, both as a boost::adjacency_list and as a CSRGraph
+    Graph social_network;
+    boost::unordered_map<std::string, VertexDescriptor> string_to_vertex_descriptor_map;
+
+    read_adjacency_list<boost::vertex_name_t>(
+        social_network,
+        string_to_vertex_descriptor_map,
+        input_graph_path
+    );
+
+    boost::unordered_map<std::string, CSRGraph::vertex_descriptor> string_to_csr_graph_vertex_descriptor_map;
+    const CSRGraph csr_social_network = load_csr_graph(
+        string_to_csr_graph_vertex_descriptor_map,
+        input_graph_path
+    );
+
+    // calculate core numbers with calculate_core_number() on both graphs,
+    // with calculate_core_number_in_flat_arrays() on the CSRGraph with 64-bit and 32-bit indices,
+    // and with calculate_core_number_in_parallel() on the CSRGraph with 32-bit indices and number_of_threads threads
+    std::vector<boost::graph_traits<Graph>::degree_size_type> core_number;
+    std::vector<time_t> adjacency_list_runtimes_microseconds = profile<std::chrono::microseconds>(
+        [&social_network, &core_number]() {
+            core_number = calculate_core_number(social_network);
+        }
+    );
+
+    std::vector<CSRGraph::degree_size_type> csr_graph_core_number;
+    std::vector<time_t> csr_graph_runtimes_microseconds = profile<std::chrono::microseconds>(
+        [&csr_social_network, &csr_graph_core_number]() {
+            csr_graph_core_number = calculate_core_number(csr_social_network);
+        }
+    );
+
+    std::vector<uint64_t> flat_arrays_64_core_number;
+    std::vector<time_t> flat_arrays_64_runtimes_microseconds = profile<std::chrono::microseconds>(
+        [&csr_social_network, &flat_arrays_64_core_number]() {
+            flat_arrays_64_core_number = calculate_core_number_in_flat_arrays<uint64_t>(csr_social_network);
+        }
+    );
+
+    std::vector<uint32_t> flat_arrays_32_core_number;
+    std::vector<time_t> flat_arrays_32_runtimes_microseconds = profile<std::chrono::microseconds>(
+        [&csr_social_network, &flat_arrays_32_core_number]() {
+            flat_arrays_32_core_number = calculate_core_number_in_flat_arrays<uint32_t>(csr_social_network);
+        }
+    );
+
+    std::vector<uint32_t> parallel_core_number;
+    std::vector<time_t> parallel_runtimes_microseconds = profile<std::chrono::microseconds>(
+        [&csr_social_network, number_of_threads, &parallel_core_number]() {
+            parallel_core_number = calculate_core_number_in_parallel<uint32_t>(csr_social_network, number_of_threads);
+        }
+    );
+
+    const bool are_core_numbers_equal = std::equal(core_number.cbegin(), core_number.cend(), csr_graph_core_number.cbegin())
+        && std::equal(core_number.cbegin(), core_number.cend(), flat_arrays_64_core_number.cbegin())
+        && std::equal(core_number.cbegin(), core_number.cend(), flat_arrays_32_core_number.cbegin())
+        && std::equal(core_number.cbegin(), core_number.cend(), parallel_core_number.cbegin());
+    std::cout << "are_core_numbers_equal: " << are_core_numbers_equal << '\n';
+
+    // write output_path
+    std::ofstream output_file_stream(output_path);
+    output_file_stream
+        << '{'
+        << std::quoted("number_of_vertices") << ':' << boost::num_vertices(social_network) << ','
+        << std::quoted("number_of_edges") << ':' << boost::num_edges(social_network) << ','
+        << std::quoted("adjacency_list_runtimes_microseconds") << ':' << adjacency_list_runtimes_microseconds << ','
+        << std::quoted("csr_graph_runtimes_microseconds") << ':' << csr_graph_runtimes_microseconds << ','
+        << std::quoted("flat_arrays_64_runtimes_microseconds") << ':' << flat_arrays_64_runtimes_microseconds << ','
+        << std::quoted("flat_arrays_32_runtimes_microseconds") << ':' << flat_arrays_32_runtimes_microseconds << ','
+        << std::quoted("number_of_threads") << ':' << number_of_threads << ','
+        << std::quoted("parallel_runtimes_microseconds") << ':' << parallel_runtimes_microseconds
+        << '}'
+        << '\n';
+
+    return are_core_numbers_equal ? 0 : 1;
+}
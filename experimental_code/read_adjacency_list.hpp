@@ -30,6 +30,12 @@
  * typedef boost::adjacency_list<boost::vecS, boost::vecS, boost::undirectedS, boost::property<boost::vertex_name_t, std::string>> Graph;
  * Graph graph;
  * read_adjacency_list<boost::vertex_name_t>(graph, std::cin);
+ * 
+ * Reading from a file path instead of a stream (read_adjacency_list<boost::vertex_name_t>(graph, "graph.txt")) maps the file into memory,
+ * scans it with a separator lookup table, and looks up names as views into the mapping in a VertexNameTable,
+ * building a std::string only once per vertex.
+ * It produces the same graph, with the same vertex and edge order, as reading the file as a stream.
+ * A CSR graph file (see csr_graph_file.hpp), e.g., converted from an adjacency list with convert_graph, is read with read_csr_graph_file() instead.
  */
 
 // References
@@ -48,12 +54,26 @@
 // https://stackoverflow.com/questions/53550797/how-do-you-access-edge-properties-in-the-boost-graph-library
 // https://stackoverflow.com/questions/67110765/using-boost-how-can-i-put-get-custom-edge-properties-as-a-struct
 
+#include <stdint.h>
+#include <string.h>
+
+#include <array>
+#include <cctype>
+#include <fstream>
 #include <iostream>
+#include <stdexcept>
 #include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
 #include <boost/tokenizer.hpp>
 #include <boost/graph/graph_traits.hpp>
 
+#include "csr_graph_file.hpp"
+
 
 template <typename Graph, typename StringToVertexDescriptorMap, typename PropertyMap> inline typename boost::graph_traits<Graph>::vertex_descriptor& get_or_insert_vertex(
     Graph& graph,
@@ -122,6 +142,203 @@ template <typename PropertyTag, typename Graph, typename StringToVertexDescripto
     }
 }
 
+// Whether each character is a separator, i.e., satisfies std::isspace() or std::ispunct() (as for boost::tokenizer<>),
+// so every ASCII whitespace and punctuation character (e.g., ';', '-', '.', '_') separates names, not only space, tab, and comma
+inline const std::array<bool, 256>& get_adjacency_list_separator_table() {
+    static const std::array<bool, 256> separator_table = []() {
+        std::array<bool, 256> separator_table;
+        for (int character = 0; character < 256; ++character) {
+            // boost::tokenizer<> passes (possibly negative) chars to std::isspace() and std::ispunct()
+            const int value = static_cast<char>(character);
+            separator_table[character] = (value >= 0) && (std::isspace(value) || std::ispunct(value));
+        }
+        return separator_table;
+    }();
+
+    return separator_table;
+}
+
+// An open-addressing hash table (with linear probing) of names, as views into the input, to vertex descriptors.
+// Unlike a node-based map keyed by std::string, it neither allocates per name nor chases pointers on lookups.
+template <typename VertexDescriptor> struct VertexNameTable {
+    struct Slot {
+        const char* name;
+        size_t size;
+        size_t hash;
+        VertexDescriptor vertex_descriptor;
+    };
+
+    // empty slots have a null name, and the number of slots is a power of 2 at least twice the number of names
+    std::vector<Slot> slots;
+    size_t number_of_names;
+
+    VertexNameTable(): slots(1024, Slot { nullptr, 0, 0, VertexDescriptor() }), number_of_names(0) { }
+
+    // 64-bit FNV-1a
+    static size_t calculate_hash(const char* name, const size_t size) {
+        uint64_t hash = 14695981039346656037ULL;
+        for (size_t position = 0; position < size; ++position) {
+            hash = (hash ^ static_cast<unsigned char>(name[position])) * 1099511628211ULL;
+        }
+        return static_cast<size_t>(hash);
+    }
+
+    const VertexDescriptor* find(const char* name, const size_t size, const size_t hash) const {
+        const size_t mask = slots.size() - 1;
+
+        for (size_t slot_index = hash & mask; slots[slot_index].name != nullptr; slot_index = (slot_index + 1) & mask) {
+            const Slot& slot = slots[slot_index];
+            if (slot.hash == hash && slot.size == size && memcmp(slot.name, name, size) == 0) {
+                return &slot.vertex_descriptor;
+            }
+        }
+
+        return nullptr;
+    }
+
+    // name must not be in the table yet
+    void insert(const char* name, const size_t size, const size_t hash, const VertexDescriptor& vertex_descriptor) {
+        if (2 * (number_of_names + 1) > slots.size()) {
+            std::vector<Slot> old_slots(2 * slots.size(), Slot { nullptr, 0, 0, VertexDescriptor() });
+            old_slots.swap(slots);
+
+            for (const Slot& slot: old_slots) {
+                if (slot.name != nullptr) insert_into_slots(slot);
+            }
+        }
+
+        insert_into_slots(Slot { name, size, hash, vertex_descriptor });
+        ++number_of_names;
+    }
+
+    void insert_into_slots(const Slot& new_slot) {
+        const size_t mask = slots.size() - 1;
+
+        size_t slot_index = new_slot.hash & mask;
+        while (slots[slot_index].name != nullptr) slot_index = (slot_index + 1) & mask;
+
+        slots[slot_index] = new_slot;
+    }
+};
+
+template <typename PropertyTag, typename Graph, typename StringToVertexDescriptorMap> void read_adjacency_list(
+    Graph& graph,
+    StringToVertexDescriptorMap& string_to_vertex_descriptor_map,
+    const std::string& input_path
+) {
+    // Get the property map for the property specified by the PropertyTag type    
+    typename boost::property_map<Graph, PropertyTag>::type property_map = boost::get(
+        PropertyTag(),
+        graph
+    );
+
+    if (is_csr_graph_file(input_path)) {
+        read_csr_graph_file<PropertyTag>(
+            graph,
+            string_to_vertex_descriptor_map,
+            input_path
+        );
+        return;
+    }
+
+    // Empty files cannot be mapped
+    std::ifstream input_file_stream(input_path, std::ios::binary | std::ios::ate);
+    if (!input_file_stream) {
+        throw std::runtime_error("read_adjacency_list: cannot open " + input_path);
+    }
+    if (input_file_stream.tellg() == 0) return;
+    input_file_stream.close();
+
+    boost::interprocess::file_mapping file_mapping(input_path.c_str(), boost::interprocess::read_only);
+    boost::interprocess::mapped_region mapped_region(file_mapping, boost::interprocess::read_only);
+    mapped_region.advise(boost::interprocess::mapped_region::advice_sequential);
+
+    const char* const begin = static_cast<const char*>(mapped_region.get_address());
+    const char* const end = begin + mapped_region.get_size();
+
+    const std::array<bool, 256>& separator_table = get_adjacency_list_separator_table();
+    const auto is_separator = [&separator_table](const char character) {
+        return separator_table[static_cast<unsigned char>(character)];
+    };
+
+    // Names are looked up as views into the mapping, and only names seen for the first time go through get_or_insert_vertex()
+    VertexNameTable<typename boost::graph_traits<Graph>::vertex_descriptor> vertex_name_table;
+
+    const auto get_or_insert_vertex_by_view = [&](const char* const name, const size_t size) {
+        const size_t hash = VertexNameTable<typename boost::graph_traits<Graph>::vertex_descriptor>::calculate_hash(name, size);
+
+        const typename boost::graph_traits<Graph>::vertex_descriptor* found_vertex_descriptor = vertex_name_table.find(name, size, hash);
+        if (found_vertex_descriptor != nullptr) return *found_vertex_descriptor;
+
+        const typename boost::graph_traits<Graph>::vertex_descriptor vertex_descriptor = get_or_insert_vertex(
+            graph,
+            string_to_vertex_descriptor_map,
+            property_map,
+            std::string(name, size)
+        );
+        vertex_name_table.insert(name, size, hash, vertex_descriptor);
+        return vertex_descriptor;
+    };
+
+    // Collect the edges, adding vertices in order of first appearance, then add the edges in order
+    std::vector<
+        std::pair<
+            typename boost::graph_traits<Graph>::vertex_descriptor,
+            typename boost::graph_traits<Graph>::vertex_descriptor
+        >
+    > edges;
+
+    const char* line_begin = begin;
+    while (line_begin != end) {
+        const char* line_end = static_cast<const char*>(memchr(line_begin, '\n', end - line_begin));
+        if (line_end == nullptr) line_end = end;
+
+        // The first token is the edges' tail, and the remaining tokens are the edges' heads
+        bool has_edges_tail = false;
+        typename boost::graph_traits<Graph>::vertex_descriptor edges_tail = typename boost::graph_traits<Graph>::vertex_descriptor();
+
+        const char* position = line_begin;
+        while (true) {
+            while (position != line_end && is_separator(*position)) ++position;
+            if (position == line_end) break;
+
+            const char* const token_begin = position;
+            while (position != line_end && !is_separator(*position)) ++position;
+
+            const typename boost::graph_traits<Graph>::vertex_descriptor vertex_descriptor = get_or_insert_vertex_by_view(
+                token_begin,
+                position - token_begin
+            );
+
+            if (!has_edges_tail) {
+                edges_tail = vertex_descriptor;
+                has_edges_tail = true;
+            }
+            else {
+                edges.emplace_back(edges_tail, vertex_descriptor);
+            }
+        }
+
+        line_begin = (line_end == end) ? end : line_end + 1;
+    }
+
+    for (const auto& edge: edges) {
+        boost::add_edge(edge.first, edge.second, graph);
+    }
+}
+
+template <typename PropertyTag, typename Graph> void read_adjacency_list(
+    Graph& graph,
+    const std::string& input_path
+) {
+    std::unordered_map<std::string, typename boost::graph_traits<Graph>::vertex_descriptor> string_to_vertex_descriptor_map;
+    return read_adjacency_list<PropertyTag>(
+        graph,
+        string_to_vertex_descriptor_map,
+        input_path
+    );
+}
+
 template <typename PropertyTag, typename Graph> void read_adjacency_list(
     Graph& graph,
     std::istream& input_stream
@@ -7,7 +7,7 @@
 
 template <typename T> std::vector<T> sizes_to_offsets(const std::vector<T>& sizes) {
     std::vector<T> offsets;
-    std::accumulate(sizes.cbegin(), sizes.cend(), 0, [&offsets](const T& accumulated_value, const T& next_value) {
+    std::accumulate(sizes.cbegin(), sizes.cend(), T(0), [&offsets](const T& accumulated_value, const T& next_value) {
         offsets.push_back(accumulated_value);
         return accumulated_value + next_value;
     });
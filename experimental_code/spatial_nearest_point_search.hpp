@@ -0,0 +1,283 @@
+#ifndef SPATIAL_NEAREST_POINT_SEARCH_HPP
+#define SPATIAL_NEAREST_POINT_SEARCH_HPP
+
+#include <math.h>
+#include <stddef.h>
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include <boost/functional/hash.hpp>
+#include <boost/unordered_map.hpp>
+
+#include "haversine.hpp"
+#include "point.h"
+#include "trajectory.h"
+
+
+// Finds the point of a trajectory closest in space to a given point, using a k-d tree over the points as 3D unit vectors.
+// Returns exactly what min_element_and_value() over the whole trajectory with haversine_one_to_many() would (as scan() does),
+// i.e., among the points with the smallest distance, the one appearing first in the trajectory.
+// The k-d tree only prunes points that are farther away than the best point found so far by more than the error of haversine(),
+// and every remaining candidate is evaluated with haversine_one_to_many() itself, whose distance of a pair does not depend on the batch.
+// The trajectory must outlive the search and must not be empty.
+struct SpatialNearestPointSearch {
+    // below this many points, scanning the trajectory is faster than building a k-d tree
+    static const size_t MIN_NUMBER_OF_POINTS_FOR_K_D_TREE = 32;
+    static const size_t MAX_NUMBER_OF_POINTS_IN_LEAF = 8;
+
+    // a bound on the rounding error of haversine() and its batched kernels, in meters (it is about 0.25m for nearly antipodal points and far smaller otherwise)
+    static constexpr double HAVERSINE_ERROR = 1;
+    // a bound on the rounding error of chord lengths between unit vectors
+    static constexpr double CHORD_LENGTH_ERROR = 1e-9;
+    // the error bounds above hold for coordinates up to this magnitude, in degrees
+    static constexpr double MAX_ABSOLUTE_COORDINATE = 1000;
+
+    const Trajectory& to;
+
+    // the coordinates of to as structure-of-arrays, for haversine_one_to_many()
+    std::vector<double> latitudes;
+    std::vector<double> longitudes;
+
+    // the first point at each distinct location, as an index into to and a unit vector, in k-d tree order
+    struct IndexedUnitVector {
+        size_t index;
+        std::array<double, 3> unit_vector;
+    };
+    std::vector<IndexedUnitVector> indexed_unit_vectors;
+    // the split dimension and coordinate of the k-d tree node [begin, end) are stored at its split position (begin + end) / 2
+    std::vector<unsigned char> split_dimensions;
+    std::vector<double> split_coordinates;
+    // the coordinates of the points in k-d tree order, for evaluating leaves with haversine_one_to_many()
+    std::vector<double> k_d_tree_latitudes;
+    std::vector<double> k_d_tree_longitudes;
+    // points with finite coordinates beyond MAX_ABSOLUTE_COORDINATE, which are always evaluated
+    std::vector<size_t> indices_outside_k_d_tree;
+
+    SpatialNearestPointSearch(const Trajectory& t_to):
+        to(t_to),
+        latitudes(t_to.size()),
+        longitudes(t_to.size()) {
+        for (size_t index = 0; index < to.size(); ++index) {
+            latitudes[index] = to[index].latitude;
+            longitudes[index] = to[index].longitude;
+        }
+
+        if (to.size() < MIN_NUMBER_OF_POINTS_FOR_K_D_TREE) return;
+
+        // points at the same location have the same haversine() to any point, and the first of them wins ties
+        boost::unordered_map<std::pair<double, double>, size_t> location_to_first_index_map;
+        for (size_t index = 0; index < to.size(); ++index) {
+            const Point& point = to[index];
+
+            // points with non-finite coordinates have a NaN haversine(), and are never closer than any other point
+            if (!isfinite(point.latitude) || !isfinite(point.longitude)) continue;
+
+            if (!has_moderate_coordinates(point)) {
+                indices_outside_k_d_tree.push_back(index);
+            }
+            else if (location_to_first_index_map.emplace(std::make_pair(point.latitude, point.longitude), index).second) {
+                indexed_unit_vectors.push_back({ index, to_unit_vector(point) });
+            }
+        }
+
+        split_dimensions.resize(indexed_unit_vectors.size());
+        split_coordinates.resize(indexed_unit_vectors.size());
+        build(0, indexed_unit_vectors.size());
+
+        for (const IndexedUnitVector& indexed_unit_vector: indexed_unit_vectors) {
+            k_d_tree_latitudes.push_back(to[indexed_unit_vector.index].latitude);
+            k_d_tree_longitudes.push_back(to[indexed_unit_vector.index].longitude);
+        }
+    }
+
+    static bool has_moderate_coordinates(const Point& point) {
+        return fabs(point.latitude) <= MAX_ABSOLUTE_COORDINATE && fabs(point.longitude) <= MAX_ABSOLUTE_COORDINATE;
+    }
+
+    static std::array<double, 3> to_unit_vector(const Point& point) {
+        const double latitude_in_radians = point.latitude * DEGREES_TO_RADIANS;
+        const double longitude_in_radians = point.longitude * DEGREES_TO_RADIANS;
+
+        return {
+            cos(latitude_in_radians) * cos(longitude_in_radians),
+            cos(latitude_in_radians) * sin(longitude_in_radians),
+            sin(latitude_in_radians)
+        };
+    }
+
+    void build(const size_t begin, const size_t end) {
+        if (end - begin <= MAX_NUMBER_OF_POINTS_IN_LEAF) return;
+
+        // split along the dimension with the largest spread
+        std::array<double, 3> min_coordinates = indexed_unit_vectors[begin].unit_vector, max_coordinates = indexed_unit_vectors[begin].unit_vector;
+        for (size_t position = begin + 1; position < end; ++position) {
+            for (size_t dimension = 0; dimension < 3; ++dimension) {
+                min_coordinates[dimension] = std::min(min_coordinates[dimension], indexed_unit_vectors[position].unit_vector[dimension]);
+                max_coordinates[dimension] = std::max(max_coordinates[dimension], indexed_unit_vectors[position].unit_vector[dimension]);
+            }
+        }
+
+        unsigned char split_dimension = 0;
+        for (unsigned char dimension = 1; dimension < 3; ++dimension) {
+            if (max_coordinates[dimension] - min_coordinates[dimension] > max_coordinates[split_dimension] - min_coordinates[split_dimension]) {
+                split_dimension = dimension;
+            }
+        }
+
+        const size_t split_position = (begin + end) / 2;
+
+        std::nth_element(
+            indexed_unit_vectors.begin() + begin,
+            indexed_unit_vectors.begin() + split_position,
+            indexed_unit_vectors.begin() + end,
+            [split_dimension](const IndexedUnitVector& first, const IndexedUnitVector& second) {
+                return first.unit_vector[split_dimension] < second.unit_vector[split_dimension];
+            }
+        );
+
+        split_dimensions[split_position] = split_dimension;
+        split_coordinates[split_position] = indexed_unit_vectors[split_position].unit_vector[split_dimension];
+
+        build(begin, split_position);
+        build(split_position, end);
+    }
+
+    // the chord length beyond which points are certainly farther away than nearest_distance according to haversine()
+    static double calculate_max_chord_length(const double nearest_distance) {
+        const double max_angle = (nearest_distance + HAVERSINE_ERROR) / EARTH_RADIUS;
+
+        if (max_angle >= M_PI) return std::numeric_limits<double>::infinity();
+
+        return 2 * sin(max_angle / 2) + CHORD_LENGTH_ERROR;
+    }
+
+    void search(
+        const size_t begin,
+        const size_t end,
+        const Point& source,
+        const std::array<double, 3>& source_unit_vector,
+        size_t& nearest_index,
+        double& nearest_distance,
+        double& max_chord_length
+    ) const {
+        if (end - begin <= MAX_NUMBER_OF_POINTS_IN_LEAF) {
+            std::array<double, MAX_NUMBER_OF_POINTS_IN_LEAF> distances;
+            haversine_one_to_many(
+                source.latitude,
+                source.longitude,
+                k_d_tree_latitudes.data() + begin,
+                k_d_tree_longitudes.data() + begin,
+                end - begin,
+                distances.data()
+            );
+
+            for (size_t position = begin; position < end; ++position) {
+                const size_t index = indexed_unit_vectors[position].index;
+                const double distance = distances[position - begin];
+
+                if (distance < nearest_distance || (distance == nearest_distance && index < nearest_index)) {
+                    nearest_index = index;
+                    nearest_distance = distance;
+                    max_chord_length = calculate_max_chord_length(nearest_distance);
+                }
+            }
+
+            return;
+        }
+
+        const size_t split_position = (begin + end) / 2;
+        const unsigned char split_dimension = split_dimensions[split_position];
+
+        // points before split_position are at or below the split coordinate, the others at or above it
+        const double difference = source_unit_vector[split_dimension] - split_coordinates[split_position];
+
+        if (difference < 0) {
+            search(begin, split_position, source, source_unit_vector, nearest_index, nearest_distance, max_chord_length);
+            if (-difference <= max_chord_length) {
+                search(split_position, end, source, source_unit_vector, nearest_index, nearest_distance, max_chord_length);
+            }
+        }
+        else {
+            search(split_position, end, source, source_unit_vector, nearest_index, nearest_distance, max_chord_length);
+            if (difference <= max_chord_length) {
+                search(begin, split_position, source, source_unit_vector, nearest_index, nearest_distance, max_chord_length);
+            }
+        }
+    }
+
+    // the same as min_element_and_value() over to with the distances of haversine_one_to_many(), evaluated in one batch
+    std::pair<Trajectory::const_iterator, double> scan(const Point& source) const {
+        std::array<double, MIN_NUMBER_OF_POINTS_FOR_K_D_TREE> small_distances;
+        std::vector<double> large_distances;
+
+        double* distances = small_distances.data();
+        if (to.size() > MIN_NUMBER_OF_POINTS_FOR_K_D_TREE) {
+            large_distances.resize(to.size());
+            distances = large_distances.data();
+        }
+
+        haversine_one_to_many(
+            source.latitude,
+            source.longitude,
+            latitudes.data(),
+            longitudes.data(),
+            to.size(),
+            distances
+        );
+
+        size_t nearest_index = 0;
+        for (size_t index = 1; index < to.size(); ++index) {
+            if (distances[index] < distances[nearest_index]) {
+                nearest_index = index;
+            }
+        }
+
+        return { to.cbegin() + nearest_index, distances[nearest_index] };
+    }
+
+    std::pair<Trajectory::const_iterator, double> find_nearest_point(const Point& source) const {
+        if (to.size() < MIN_NUMBER_OF_POINTS_FOR_K_D_TREE) return scan(source);
+
+        // a batch of one, so that its distances compare equal to those of the leaves
+        const auto spatial_distance = [&source](const Point& target) {
+            double distance;
+            haversine_one_to_many(
+                source.latitude,
+                source.longitude,
+                &target.latitude,
+                &target.longitude,
+                1,
+                &distance
+            );
+            return distance;
+        };
+
+        // start from the first point, which wins unless another point is strictly closer
+        size_t nearest_index = 0;
+        double nearest_distance = spatial_distance(to.front());
+
+        // a NaN haversine() of the first point (e.g., for a source with non-finite coordinates) is never replaced
+        if (isnan(nearest_distance) || !has_moderate_coordinates(source)) return scan(source);
+
+        for (const size_t index: indices_outside_k_d_tree) {
+            const double distance = spatial_distance(to[index]);
+
+            if (distance < nearest_distance || (distance == nearest_distance && index < nearest_index)) {
+                nearest_index = index;
+                nearest_distance = distance;
+            }
+        }
+
+        double max_chord_length = calculate_max_chord_length(nearest_distance);
+
+        search(0, indexed_unit_vectors.size(), source, to_unit_vector(source), nearest_index, nearest_distance, max_chord_length);
+
+        return { to.cbegin() + nearest_index, nearest_distance };
+    }
+};
+
+#endif
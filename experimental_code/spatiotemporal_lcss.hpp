@@ -7,15 +7,81 @@
 #include <limits>
 #include <tuple>
 #include <utility>
-
-#include <boost/unordered_set.hpp>
-#include <eigen3/Eigen/Core>
+#include <vector>
 
 #include "haversine.hpp"
 #include "point.h"
 #include "trajectory.h"
 
 
+bool is_sorted_by_timestamp(const Trajectory& trajectory) {
+    return std::is_sorted(
+        trajectory.cbegin(),
+        trajectory.cend(),
+        [](const Point& first, const Point& second) {
+            return first.timestamp < second.timestamp;
+        }
+    );
+}
+
+
+// For first_trajectory sorted by timestamp, moves [lo, hi) forward to the points closer than delta in time to second_point,
+// plus any points in between, given that second_point is not earlier than in the previous call.
+template <typename TemporalDistance> void advance_temporal_band(
+    const Trajectory& first_trajectory,
+    const Point& second_point,
+    const double delta,
+    const TemporalDistance& temporal_distance,
+    size_t& lo,
+    size_t& hi
+) {
+    const size_t first_trajectory_length = first_trajectory.size();
+
+    // skip points too early to match second_point
+    while (
+        lo < first_trajectory_length &&
+        first_trajectory[lo].timestamp < second_point.timestamp &&
+        !(temporal_distance(first_trajectory[lo], second_point) < delta)
+    ) {
+        ++lo;
+    }
+
+    // include points early enough to match second_point
+    hi = std::max(hi, lo);
+    while (
+        hi < first_trajectory_length &&
+        (first_trajectory[hi].timestamp <= second_point.timestamp || temporal_distance(first_trajectory[hi], second_point) < delta)
+    ) {
+        ++hi;
+    }
+}
+
+
+// the coordinates of a trajectory as structure-of-arrays, for the batched haversine() kernels
+void get_latitudes_and_longitudes(
+    const Trajectory& trajectory,
+    std::vector<double>& latitudes,
+    std::vector<double>& longitudes
+) {
+    latitudes.resize(trajectory.size());
+    longitudes.resize(trajectory.size());
+
+    for (size_t i = 0; i < trajectory.size(); ++i) {
+        latitudes[i] = trajectory[i].latitude;
+        longitudes[i] = trajectory[i].longitude;
+    }
+}
+
+
+// Only points closer than delta in time can match, so if both trajectories are sorted by timestamp,
+// the first points of first_trajectory matching the j-th point of second_trajectory are within a band [lo, hi),
+// and lo and hi never decrease with j.
+// For the j-th column of the DP:
+// - above the band, the column equals the previous column (the j-th point matches none of the first i points),
+// - below the band, the column is constant (none of the remaining points matches any of the first j points).
+// Thus, only the band is evaluated, in a single rolling column holding rows [window_begin, hi],
+// with the spatial distances of the band calculated in one batch.
+// If either trajectory is not sorted by timestamp, the band spans all rows.
 double spatiotemporal_lcss(
     const Trajectory& first_trajectory,
     const Trajectory& second_trajectory,
@@ -44,40 +110,82 @@ double spatiotemporal_lcss(
     };
 
     const size_t first_trajectory_length = first_trajectory.size(), second_trajectory_length = second_trajectory.size();
-    
-    Eigen::Array<size_t, Eigen::Dynamic, Eigen::Dynamic> common_points_between_first_i_points_of_first_trajectory_and_first_j_points_of_second_trajectory(
-        first_trajectory_length + 1,
-        second_trajectory_length + 1
-    );
-    
-    size_t i, j;
 
-    for (i = 0; i <= first_trajectory_length; ++i) {
-        common_points_between_first_i_points_of_first_trajectory_and_first_j_points_of_second_trajectory(i, 0) = 0;
-    }
+    const bool is_banded = is_sorted_by_timestamp(first_trajectory) && is_sorted_by_timestamp(second_trajectory);
 
-    for (j = 0; j <= second_trajectory_length; ++j) {
-        common_points_between_first_i_points_of_first_trajectory_and_first_j_points_of_second_trajectory(0, j) = 0;
+    std::vector<double> first_latitudes, first_longitudes, spatial_distances;
+    if (is_banded) {
+        get_latitudes_and_longitudes(first_trajectory, first_latitudes, first_longitudes);
     }
 
-    for (j = 1; j <= second_trajectory_length; ++j) {
-        for (i = 1; i <= first_trajectory_length; ++i) {
+    // common points between the first i points of first_trajectory and the first j points of second_trajectory,
+    // for i in [window_begin, window_begin + window.size()), and the last value for all larger i
+    std::vector<size_t> window { 0 };
+    size_t window_begin = 0;
+
+    size_t lo = 0, hi = 0;
+
+    for (size_t j = 1; j <= second_trajectory_length; ++j) {
+        const Point& second_point = second_trajectory[j - 1];
+
+        if (is_banded) {
+            advance_temporal_band(first_trajectory, second_point, delta, temporal_distance, lo, hi);
+
+            if (lo == hi) continue;
+
+            spatial_distances.resize(hi - lo);
+            haversine_many_to_one(
+                first_latitudes.data() + lo,
+                first_longitudes.data() + lo,
+                hi - lo,
+                second_point.latitude,
+                second_point.longitude,
+                spatial_distances.data()
+            );
+        }
+        else {
+            lo = 0, hi = first_trajectory_length;
+        }
+
+        // materialize rows up to hi, which equal the last row so far
+        while (window_begin + window.size() <= hi) {
+            window.push_back(window.back());
+        }
+
+        // evaluate rows (lo, hi]
+        size_t diagonal = window[lo - window_begin];
+        for (size_t i = lo + 1; i <= hi; ++i) {
+            size_t& common_points = window[i - window_begin];
+            const size_t left = common_points, up = window[i - 1 - window_begin];
+
             // match
-            if (is_same_point(first_trajectory[i - 1], second_trajectory[j - 1])) {
-                common_points_between_first_i_points_of_first_trajectory_and_first_j_points_of_second_trajectory(i, j) = common_points_between_first_i_points_of_first_trajectory_and_first_j_points_of_second_trajectory(i - 1, j - 1) + 1;
+            if (
+                is_banded ?
+                ((temporal_distance(first_trajectory[i - 1], second_point) < delta) && (spatial_distances[i - 1 - lo] < epsilon)) :
+                is_same_point(first_trajectory[i - 1], second_point)
+            ) {
+                common_points = diagonal + 1;
             }
             else {
-                if (common_points_between_first_i_points_of_first_trajectory_and_first_j_points_of_second_trajectory(i, j - 1) > common_points_between_first_i_points_of_first_trajectory_and_first_j_points_of_second_trajectory(i - 1, j)) {
-                    common_points_between_first_i_points_of_first_trajectory_and_first_j_points_of_second_trajectory(i, j) = common_points_between_first_i_points_of_first_trajectory_and_first_j_points_of_second_trajectory(i, j - 1);
+                if (left > up) {
+                    common_points = left;
                 }
                 else {
-                    common_points_between_first_i_points_of_first_trajectory_and_first_j_points_of_second_trajectory(i, j) = common_points_between_first_i_points_of_first_trajectory_and_first_j_points_of_second_trajectory(i - 1, j);
+                    common_points = up;
                 }
             }
+
+            diagonal = left;
+        }
+
+        // rows before lo are never needed again
+        if (lo - window_begin > window.size() / 2) {
+            window.erase(window.begin(), window.begin() + (lo - window_begin));
+            window_begin = lo;
         }
     }
 
-    size_t common_points = common_points_between_first_i_points_of_first_trajectory_and_first_j_points_of_second_trajectory(first_trajectory_length, second_trajectory_length);
+    size_t common_points = window.back();
     
     return (double)common_points / (double)std::min(first_trajectory_length, second_trajectory_length);
 }
@@ -112,53 +220,90 @@ template <typename MatchingPointCallback> double spatiotemporal_lcss(
     };
 
     const size_t first_trajectory_length = first_trajectory.size(), second_trajectory_length = second_trajectory.size();
-    
-    Eigen::Array<size_t, Eigen::Dynamic, Eigen::Dynamic> common_points_between_first_i_points_of_first_trajectory_and_first_j_points_of_second_trajectory(
-        first_trajectory_length + 1,
-        second_trajectory_length + 1
-    );
-    
-    size_t i, j;
 
-    for (i = 0; i <= first_trajectory_length; ++i) {
-        common_points_between_first_i_points_of_first_trajectory_and_first_j_points_of_second_trajectory(i, 0) = 0;
-    }
+    // common points between the first i points of first_trajectory and the first j points of second_trajectory, for the current j
+    std::vector<size_t> common_points_between_first_i_points_of_first_trajectory_and_first_j_points_of_second_trajectory(first_trajectory_length + 1, 0);
+
+    // for each cell (i, j), whether (i - 1, j - 1) is a matching point, and otherwise, whether the traceback moves left to (i, j - 1)
+    // these two bits per cell replace the full DP matrix
+    std::vector<bool> is_same_point_bits(first_trajectory_length * second_trajectory_length);
+    std::vector<bool> is_moving_left_bits(first_trajectory_length * second_trajectory_length);
+
+    const auto get_bit_index = [first_trajectory_length](const size_t i, const size_t j) {
+        return (j - 1) * first_trajectory_length + (i - 1);
+    };
 
-    for (j = 0; j <= second_trajectory_length; ++j) {
-        common_points_between_first_i_points_of_first_trajectory_and_first_j_points_of_second_trajectory(0, j) = 0;
+    // if both trajectories are sorted by timestamp, only the temporal band [lo, hi) of each column can match,
+    // and its spatial distances are calculated in one batch
+    const bool is_banded = is_sorted_by_timestamp(first_trajectory) && is_sorted_by_timestamp(second_trajectory);
+
+    std::vector<double> first_latitudes, first_longitudes, spatial_distances;
+    if (is_banded) {
+        get_latitudes_and_longitudes(first_trajectory, first_latitudes, first_longitudes);
     }
 
-    boost::unordered_set<std::pair<size_t, size_t>> is_same_point_indices;
+    size_t lo = 0, hi = 0;
+
+    size_t i, j;
 
     for (j = 1; j <= second_trajectory_length; ++j) {
+        const Point& second_point = second_trajectory[j - 1];
+
+        if (is_banded) {
+            advance_temporal_band(first_trajectory, second_point, delta, temporal_distance, lo, hi);
+
+            spatial_distances.resize(hi - lo);
+            haversine_many_to_one(
+                first_latitudes.data() + lo,
+                first_longitudes.data() + lo,
+                hi - lo,
+                second_point.latitude,
+                second_point.longitude,
+                spatial_distances.data()
+            );
+        }
+
+        size_t diagonal = common_points_between_first_i_points_of_first_trajectory_and_first_j_points_of_second_trajectory[0];
+
         for (i = 1; i <= first_trajectory_length; ++i) {
+            size_t& common_points = common_points_between_first_i_points_of_first_trajectory_and_first_j_points_of_second_trajectory[i];
+            const size_t left = common_points, up = common_points_between_first_i_points_of_first_trajectory_and_first_j_points_of_second_trajectory[i - 1];
+
             // match
-            if (is_same_point(first_trajectory[i - 1], second_trajectory[j - 1])) {
-                common_points_between_first_i_points_of_first_trajectory_and_first_j_points_of_second_trajectory(i, j) = common_points_between_first_i_points_of_first_trajectory_and_first_j_points_of_second_trajectory(i - 1, j - 1) + 1;
-                
-                is_same_point_indices.emplace(i - 1, j - 1);
+            if (
+                is_banded ?
+                (lo < i && i <= hi && (temporal_distance(first_trajectory[i - 1], second_point) < delta) && (spatial_distances[i - 1 - lo] < epsilon)) :
+                is_same_point(first_trajectory[i - 1], second_point)
+            ) {
+                common_points = diagonal + 1;
+
+                is_same_point_bits[get_bit_index(i, j)] = true;
             }
             else {
-                if (common_points_between_first_i_points_of_first_trajectory_and_first_j_points_of_second_trajectory(i, j - 1) > common_points_between_first_i_points_of_first_trajectory_and_first_j_points_of_second_trajectory(i - 1, j)) {
-                    common_points_between_first_i_points_of_first_trajectory_and_first_j_points_of_second_trajectory(i, j) = common_points_between_first_i_points_of_first_trajectory_and_first_j_points_of_second_trajectory(i, j - 1);
+                if (left > up) {
+                    common_points = left;
+
+                    is_moving_left_bits[get_bit_index(i, j)] = true;
                 }
                 else {
-                    common_points_between_first_i_points_of_first_trajectory_and_first_j_points_of_second_trajectory(i, j) = common_points_between_first_i_points_of_first_trajectory_and_first_j_points_of_second_trajectory(i - 1, j);
+                    common_points = up;
                 }
             }
+
+            diagonal = left;
         }
     }
 
     i = first_trajectory_length, j = second_trajectory_length;
     while ((i > 0) && (j > 0)) {
-        if (is_same_point_indices.count({i - 1, j - 1})) {
+        if (is_same_point_bits[get_bit_index(i, j)]) {
             matching_point_callback(first_trajectory[i - 1], second_trajectory[j - 1]);
             --i;
             --j;
             continue;
         }
         else {
-            if (common_points_between_first_i_points_of_first_trajectory_and_first_j_points_of_second_trajectory(i, j - 1) > common_points_between_first_i_points_of_first_trajectory_and_first_j_points_of_second_trajectory(i - 1, j)) {
+            if (is_moving_left_bits[get_bit_index(i, j)]) {
                 --j;
                 continue;
             }
@@ -169,7 +314,7 @@ template <typename MatchingPointCallback> double spatiotemporal_lcss(
         }
     }
 
-    size_t common_points = common_points_between_first_i_points_of_first_trajectory_and_first_j_points_of_second_trajectory(first_trajectory_length, second_trajectory_length);
+    size_t common_points = common_points_between_first_i_points_of_first_trajectory_and_first_j_points_of_second_trajectory[first_trajectory_length];
     
     return (double)common_points / (double)std::min(first_trajectory_length, second_trajectory_length);
 }
@@ -0,0 +1,40 @@
+#ifndef SPLIT_INTO_CHUNKS_OF_SIMILAR_COST_HPP
+#define SPLIT_INTO_CHUNKS_OF_SIMILAR_COST_HPP
+
+#include <stddef.h>
+
+#include <vector>
+
+
+// Splits the items [0, number_of_items) into at most number_of_chunks contiguous chunks of similar total cost,
+// so that a few expensive items (e.g., the edges of hub vertices) do not stall a single worker.
+// Returns the offsets of the chunks, i.e., chunk i is [offsets[i], offsets[i + 1]).
+template <typename GetCost> std::vector<size_t> split_into_chunks_of_similar_cost(
+    const size_t number_of_items,
+    const GetCost& get_cost,
+    const size_t number_of_chunks
+) {
+    std::vector<double> costs(number_of_items);
+    double total_cost = 0;
+    for (size_t item = 0; item < number_of_items; ++item) {
+        costs[item] = get_cost(item);
+        total_cost += costs[item];
+    }
+
+    const double cost_per_chunk = total_cost / (double)(number_of_chunks ? number_of_chunks : 1);
+
+    std::vector<size_t> offsets { 0 };
+    double cost_of_current_chunk = 0;
+    for (size_t item = 0; item < number_of_items; ++item) {
+        cost_of_current_chunk += costs[item];
+        if (cost_of_current_chunk >= cost_per_chunk && item + 1 < number_of_items) {
+            offsets.push_back(item + 1);
+            cost_of_current_chunk = 0;
+        }
+    }
+    offsets.push_back(number_of_items);
+
+    return offsets;
+}
+
+#endif
@@ -8,6 +8,8 @@
 #include "haversine.hpp"
 #include "min_element_and_value.hpp"
 #include "point.h"
+#include "spatial_nearest_point_search.hpp"
+#include "temporal_nearest_point_search.hpp"
 #include "trajectory.h"
 
 
@@ -63,21 +65,48 @@ template <typename PointDistance, typename MatchingPointCallback> double one_way
     return sum / (double)(from.size());
 }
 
+// identical to one_way_similarity() with the point distance of NearestPointSearch,
+// finding each matching point with a NearestPointSearch built on to instead of scanning to
+template <typename NearestPointSearch> double one_way_similarity(
+    const Trajectory& from,
+    const Trajectory& to
+) {
+    const NearestPointSearch nearest_point_search(to);
+
+    double sum = 0;
+
+    for (const Point& source: from) {
+        sum += exp(-nearest_point_search.find_nearest_point(source).second);
+    }
+
+    return sum / (double)(from.size());
+}
+
+template <typename NearestPointSearch, typename MatchingPointCallback> double one_way_similarity(
+    const Trajectory& from,
+    const Trajectory& to,
+    const MatchingPointCallback& matching_point_callback
+) {
+    const NearestPointSearch nearest_point_search(to);
+
+    double sum = 0;
+
+    for (const Point& source: from) {
+        const auto pointer_to_matching_point_and_distance = nearest_point_search.find_nearest_point(source);
+
+        matching_point_callback(source, *pointer_to_matching_point_and_distance.first);
+        sum += exp(-pointer_to_matching_point_and_distance.second);
+    }
+
+    return sum / (double)(from.size());
+}
+
 
 double spatial_similarity(
     const Trajectory& first,
     const Trajectory& second
 ) {
-    const auto spatial_distance = [](const Point& first, const Point& second) {
-        return haversine(
-            first.latitude,
-            first.longitude,
-            second.latitude,
-            second.longitude
-        );
-    };
-
-    return one_way_similarity(first, second, spatial_distance) + one_way_similarity(second, first, spatial_distance);
+    return one_way_similarity<SpatialNearestPointSearch>(first, second) + one_way_similarity<SpatialNearestPointSearch>(second, first);
 }
 
 template <typename MatchingPointCallback> double spatial_similarity(
@@ -85,16 +114,7 @@ template <typename MatchingPointCallback> double spatial_similarity(
     const Trajectory& second,
     const MatchingPointCallback& matching_point_callback
 ) {
-    const auto spatial_distance = [](const Point& first, const Point& second) {
-        return haversine(
-            first.latitude,
-            first.longitude,
-            second.latitude,
-            second.longitude
-        );
-    };
-
-    return one_way_similarity(first, second, spatial_distance, matching_point_callback) + one_way_similarity(second, first, spatial_distance, matching_point_callback);
+    return one_way_similarity<SpatialNearestPointSearch>(first, second, matching_point_callback) + one_way_similarity<SpatialNearestPointSearch>(second, first, matching_point_callback);
 }
 
 
@@ -102,13 +122,7 @@ double temporal_similarity(
     const Trajectory& first,
     const Trajectory& second
 ) {
-    const auto temporal_distance = [](const Point& first, const Point& second) {
-        return (first.timestamp > second.timestamp) ?
-            (first.timestamp - second.timestamp) :
-            (second.timestamp - first.timestamp);
-    };
-
-    return one_way_similarity(first, second, temporal_distance) + one_way_similarity(second, first, temporal_distance);
+    return one_way_similarity<TemporalNearestPointSearch>(first, second) + one_way_similarity<TemporalNearestPointSearch>(second, first);
 }
 
 template <typename MatchingPointCallback> double temporal_similarity(
@@ -116,13 +130,7 @@ template <typename MatchingPointCallback> double temporal_similarity(
     const Trajectory& second,
     const MatchingPointCallback& matching_point_callback
 ) {
-    const auto temporal_distance = [](const Point& first, const Point& second) {
-        return (first.timestamp > second.timestamp) ?
-            (first.timestamp - second.timestamp) :
-            (second.timestamp - first.timestamp);
-    };
-
-    return one_way_similarity(first, second, temporal_distance, matching_point_callback) + one_way_similarity(second, first, temporal_distance, matching_point_callback);
+    return one_way_similarity<TemporalNearestPointSearch>(first, second, matching_point_callback) + one_way_similarity<TemporalNearestPointSearch>(second, first, matching_point_callback);
 }
 
 
@@ -143,4 +151,34 @@ template <typename MatchingPointCallback> double stlc(
     return lambda * spatial_similarity(first, second, matching_point_callback) + (1 - lambda) * temporal_similarity(second, first, matching_point_callback);
 }
 
+
+// The spatial and temporal similarities combined by stlc(), which do not depend on lambda.
+struct StlcComponents {
+    double spatial_similarity;
+    double temporal_similarity;
+};
+
+StlcComponents stlc_components(
+    const Trajectory& first,
+    const Trajectory& second
+) {
+    return { spatial_similarity(first, second), temporal_similarity(second, first) };
+}
+
+template <typename MatchingPointCallback> StlcComponents stlc_components(
+    const Trajectory& first,
+    const Trajectory& second,
+    const MatchingPointCallback& matching_point_callback
+) {
+    return { spatial_similarity(first, second, matching_point_callback), temporal_similarity(second, first, matching_point_callback) };
+}
+
+// identical to stlc(first, second, lambda), given components = stlc_components(first, second)
+double stlc(
+    const StlcComponents& components,
+    const double lambda
+) {
+    return lambda * components.spatial_similarity + (1 - lambda) * components.temporal_similarity;
+}
+
 #endif
@@ -1,5 +1,6 @@
 #include <iomanip>
 #include <fstream>
+#include <memory>
 #include <string>
 #include <tuple>
 #include <vector>
@@ -15,9 +16,11 @@
 #include "find_closest_matches.hpp"
 #include "haversine.hpp"
 #include "load_trajectory_dataset.hpp"
+#include "parse_comma_separated_values.hpp"
 #include "read_adjacency_list.hpp"
 #include "trajectory.h"
 #include "stlc.hpp"
+#include "vertex_indexed_trajectory_dataset.hpp"
 #include "write_vector.hpp"
 
 
@@ -39,8 +42,8 @@ void parse_command_line_arguments(
     const char** argv,
     std::string& input_graph_path,
     std::string& input_trajectories_path,
-    double& lambda,
-    std::string& output_pairwise_similarities_path
+    std::vector<double>& lambda_values,
+    std::vector<std::string>& output_pairwise_similarities_paths
 ) {
     // To start parsing command-line arguments, create an ArgumentParser
     argparse::ArgumentParser parser("");
@@ -72,9 +75,14 @@ void parse_command_line_arguments(
             "the parameter lambda"
         );
     
+    parser.add_argument("--lambda-values")
+        .help(
+            "a comma-separated list of values of lambda, all evaluated from the same spatial and temporal similarities (overrides --lambda)"
+        );
+    
     parser.add_argument("-o", "--output")
         .required()
-        .help("specify the output file (a CSV file with the columns first_user, second_user, similarity)");
+        .help("specify the output file (a CSV file with the columns first_user, second_user, similarity), or, with --lambda-values, the output directory (containing one output file for each lambda, e.g., <output>/<lambda>)");
     
     // Parse arguments
     try {
@@ -90,8 +98,33 @@ void parse_command_line_arguments(
     // Use arguments
     input_graph_path = parser.get<std::string>("--graph");
     input_trajectories_path = parser.get<std::string>("--trajectories");
-    lambda = parser.get<double>("--lambda");
-    output_pairwise_similarities_path = parser.get<std::string>("--output");
+    const std::string output_path = parser.get<std::string>("--output");
+    
+    const auto optional_lambda_values = parser.present<std::string>("--lambda-values");
+    
+    if (optional_lambda_values) {
+        try {
+            lambda_values = parse_comma_separated_values<double>(*optional_lambda_values);
+            
+            if (lambda_values.empty()) {
+                throw std::runtime_error("--lambda-values: no values of lambda given");
+            }
+        }
+        catch (const std::runtime_error& e) {
+            std::cerr << e.what() << '\n';
+            std::cerr << parser;
+            exit(EXIT_FAILURE);
+        }
+        
+        // name each output file after lambda as given, e.g., 0.1 rather than 0.100000
+        for (const std::string& lambda_string: parse_comma_separated_values<std::string>(*optional_lambda_values)) {
+            output_pairwise_similarities_paths.push_back(output_path + '/' + lambda_string);
+        }
+    }
+    else {
+        lambda_values = { parser.get<double>("--lambda") };
+        output_pairwise_similarities_paths = { output_path };
+    }
 }
 
 
@@ -99,27 +132,26 @@ int main(int argc, const char* argv[]) {
     // parse command line arguments
     std::string input_graph_path;
     std::string input_trajectory_path;
-    double lambda;
-    std::string output_path;
+    std::vector<double> lambda_values;
+    std::vector<std::string> output_paths;
     
     parse_command_line_arguments(
         argc,
         argv,
         input_graph_path,
         input_trajectory_path,
-        lambda,
-        output_path
+        lambda_values,
+        output_paths
     );
     
     // load social network
     Graph social_network;
     boost::unordered_map<std::string, VertexDescriptor> string_to_vertex_descriptor_map;
     
-    std::ifstream input_file_stream(input_graph_path);
     read_adjacency_list<boost::vertex_name_t>(
         social_network,
         string_to_vertex_descriptor_map,
-        input_file_stream
+        input_graph_path
     );
     
     const auto get_vertex_name = [&social_network](const VertexDescriptor& vertex_descriptor) {
@@ -132,7 +164,7 @@ int main(int argc, const char* argv[]) {
     std::vector<EdgeDescriptor> edges(edge_begin, edge_end);
     
     // load trajectory_dataset
-    boost::unordered_map<VertexDescriptor, Trajectory> trajectory_dataset;
+    VertexIndexedTrajectoryDataset trajectory_dataset(boost::num_vertices(social_network));
     
     load_trajectory_dataset(
         string_to_vertex_descriptor_map,
@@ -140,18 +172,21 @@ int main(int argc, const char* argv[]) {
         trajectory_dataset
     );
   
-    // write matching_point_spatial_temporal_distance
-    std::ofstream output_file_stream(output_path);
+    // write matching_point_spatial_temporal_distance for each lambda
+    std::vector<std::unique_ptr<std::ofstream>> output_file_streams;
+    for (const std::string& output_path: output_paths) {
+        output_file_streams.push_back(std::make_unique<std::ofstream>(output_path));
+    }
 
     enumerate(
         edge_begin,
         edge_end,
         [
-            &lambda,
+            &lambda_values,
             &social_network,
             &get_vertex_name,
             &trajectory_dataset,
-            &output_file_stream
+            &output_file_streams
         ](
             const size_t i,
             const EdgeDescriptor& edge_descriptor
@@ -164,10 +199,10 @@ int main(int argc, const char* argv[]) {
 
             std::vector<double> spatial_distances, temporal_distances;
 
-            double similarity = stlc(
+            // calculate the spatial and temporal similarities, and the matching points, once for all values of lambda
+            const StlcComponents components = stlc_components(
                 trajectory_dataset.at(source),
                 trajectory_dataset.at(target),
-                lambda,
                 [&spatial_distances, &temporal_distances](const Point& source_point, const Point& target_point) {
                     const double spatial_distance = haversine(
                         source_point.latitude,
@@ -187,15 +222,22 @@ int main(int argc, const char* argv[]) {
                 }
             );
 
-            output_file_stream
-                << '{'
-                << std::quoted("first_user") << ':' << source_name << ','
-                << std::quoted("second_user") << ':' << target_name << ','
-                << std::quoted("similarity") << ':' << similarity << ','
-                << std::quoted("spatial_distances") << ':' << spatial_distances << ','
-                << std::quoted("temporal_distances") << ':' << temporal_distances
-                << '}'
-                << '\n';
+            for (size_t lambda_index = 0; lambda_index < lambda_values.size(); ++lambda_index) {
+                double similarity = stlc(
+                    components,
+                    lambda_values[lambda_index]
+                );
+
+                *output_file_streams[lambda_index]
+                    << '{'
+                    << std::quoted("first_user") << ':' << source_name << ','
+                    << std::quoted("second_user") << ':' << target_name << ','
+                    << std::quoted("similarity") << ':' << similarity << ','
+                    << std::quoted("spatial_distances") << ':' << spatial_distances << ','
+                    << std::quoted("temporal_distances") << ':' << temporal_distances
+                    << '}'
+                    << '\n';
+            }
         }
     );
 
@@ -0,0 +1,89 @@
+#ifndef TEMPORAL_NEAREST_POINT_SEARCH_HPP
+#define TEMPORAL_NEAREST_POINT_SEARCH_HPP
+
+#include <stddef.h>
+#include <time.h>
+
+#include <algorithm>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+#include "point.h"
+#include "trajectory.h"
+
+
+// Finds the point of a trajectory closest in time to a given point in O(log n), by binary search over its sorted timestamps.
+// Returns exactly what min_element_and_value() over the whole trajectory with the temporal distance would,
+// i.e., among the closest points, the one appearing first in the trajectory.
+// The trajectory must outlive the search and must not be empty.
+struct TemporalNearestPointSearch {
+    const Trajectory& to;
+    std::vector<size_t> indices_in_ascending_order_of_timestamp;
+    std::vector<time_t> timestamps_in_ascending_order;
+
+    TemporalNearestPointSearch(const Trajectory& t_to):
+        to(t_to),
+        indices_in_ascending_order_of_timestamp(t_to.size()),
+        timestamps_in_ascending_order(t_to.size()) {
+        std::iota(indices_in_ascending_order_of_timestamp.begin(), indices_in_ascending_order_of_timestamp.end(), 0);
+
+        // points with the same timestamp keep their order in the trajectory, so the first of them comes first
+        std::stable_sort(
+            indices_in_ascending_order_of_timestamp.begin(),
+            indices_in_ascending_order_of_timestamp.end(),
+            [this](const size_t& first, const size_t& second) {
+                return to[first].timestamp < to[second].timestamp;
+            }
+        );
+
+        for (size_t i = 0; i < to.size(); ++i) {
+            timestamps_in_ascending_order[i] = to[indices_in_ascending_order_of_timestamp[i]].timestamp;
+        }
+    }
+
+    std::pair<Trajectory::const_iterator, time_t> find_nearest_point(const Point& source) const {
+        const time_t timestamp = source.timestamp;
+
+        // the first point at or after timestamp
+        const size_t later_position = std::lower_bound(
+            timestamps_in_ascending_order.cbegin(),
+            timestamps_in_ascending_order.cend(),
+            timestamp
+        ) - timestamps_in_ascending_order.cbegin();
+
+        size_t nearest_index = to.size();
+        time_t nearest_distance = 0;
+
+        if (later_position < timestamps_in_ascending_order.size()) {
+            nearest_index = indices_in_ascending_order_of_timestamp[later_position];
+            nearest_distance = timestamps_in_ascending_order[later_position] - timestamp;
+        }
+
+        if (later_position > 0) {
+            // the first point at the latest timestamp before timestamp
+            const time_t earlier_timestamp = timestamps_in_ascending_order[later_position - 1];
+            const size_t earlier_position = std::lower_bound(
+                timestamps_in_ascending_order.cbegin(),
+                timestamps_in_ascending_order.cbegin() + later_position,
+                earlier_timestamp
+            ) - timestamps_in_ascending_order.cbegin();
+
+            const size_t earlier_index = indices_in_ascending_order_of_timestamp[earlier_position];
+            const time_t earlier_distance = timestamp - earlier_timestamp;
+
+            if (
+                nearest_index == to.size() ||
+                earlier_distance < nearest_distance ||
+                (earlier_distance == nearest_distance && earlier_index < nearest_index)
+            ) {
+                nearest_index = earlier_index;
+                nearest_distance = earlier_distance;
+            }
+        }
+
+        return { to.cbegin() + nearest_index, nearest_distance };
+    }
+};
+
+#endif
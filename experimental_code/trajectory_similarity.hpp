@@ -4,11 +4,15 @@
 #include <time.h>
 
 #include <tuple>
+#include <vector>
+
+#include <eigen3/Eigen/Core>
 
 #include "find_closest_matches.hpp"
 #include "haversine.hpp"
 #include "pairwise_adaptor.hpp"
 #include "trajectory.h"
+#include "trajectory_store.hpp"
 
 
 template <typename PointSimilarity> double one_way_trajectory_similarity(
@@ -118,6 +122,237 @@ template <typename MatchingPointCallback> double trajectory_similarity(
     return (one_way_trajectory_similarity(first, second, decorated_point_similarity) + one_way_trajectory_similarity(second, first, decorated_point_similarity)) / 2;
 }
 
+// one_way_trajectory_similarity() for trajectory views, using their precomputed cosines of latitudes
+double one_way_trajectory_similarity(
+    const TrajectoryView& from,
+    const TrajectoryView& to,
+    const double delta,
+    const double tau
+) {
+    double total_time = 0;
+    double total_area = 0;
+
+    bool has_old_similarity = false;
+    double old_similarity = 0;
+    time_t old_timestamp = 0;
+
+    const auto closest_match_consumer = [
+        &from,
+        &to,
+        &delta,
+        &tau,
+        &total_time,
+        &total_area,
+        &has_old_similarity,
+        &old_similarity,
+        &old_timestamp
+    ](
+        const size_t source_index,
+        const size_t target_index
+    ) {
+        double spatial_distance = haversine(
+            from.latitudes[source_index],
+            from.longitudes[source_index],
+            from.cos_latitudes[source_index],
+            to.latitudes[target_index],
+            to.longitudes[target_index],
+            to.cos_latitudes[target_index]
+        );
+
+        double temporal_distance = (from.timestamps[source_index] >= to.timestamps[target_index]) ? (from.timestamps[source_index] - to.timestamps[target_index]) : (to.timestamps[target_index] - from.timestamps[source_index]);
+
+        double similarity = exp((-spatial_distance / delta) + (-temporal_distance / tau));
+        const time_t timestamp = to.timestamps[target_index];
+
+        if (has_old_similarity) {
+            double time_delta = timestamp - old_timestamp;
+            double area_delta = (similarity + old_similarity) * time_delta / 2;
+            total_time += time_delta;
+            total_area += area_delta;
+        }
+
+        has_old_similarity = true;
+        old_similarity = similarity;
+        old_timestamp = timestamp;
+    };
+
+    find_closest_matches(
+        from,
+        to,
+        closest_match_consumer
+    );
+
+    return total_area / total_time;
+}
+
+// identical to trajectory_similarity() on the trajectories the views were built from
+double trajectory_similarity(
+    const TrajectoryView& first,
+    const TrajectoryView& second,
+    const double delta,
+    const double tau
+) {
+    return (one_way_trajectory_similarity(first, second, delta, tau) + one_way_trajectory_similarity(second, first, delta, tau)) / 2;
+}
+
+// The closest matches found by one_way_trajectory_similarity(), which depend on timestamps only.
+// They are the same for all values of delta and tau, and can be evaluated for many of them.
+struct OneWayMatchedSequence {
+    std::vector<double> spatial_distances;
+    std::vector<double> temporal_distances;
+    std::vector<time_t> timestamps;
+};
+
+struct MatchedSequences {
+    OneWayMatchedSequence first_to_second;
+    OneWayMatchedSequence second_to_first;
+};
+
+OneWayMatchedSequence calculate_one_way_matched_sequence(
+    const Trajectory& from,
+    const Trajectory& to
+) {
+    OneWayMatchedSequence one_way_matched_sequence;
+
+    // the coordinates of the matches, whose spatial distances are calculated in one batch
+    std::vector<double> source_latitudes, source_longitudes, target_latitudes, target_longitudes;
+
+    const auto closest_match_consumer = [
+        &one_way_matched_sequence,
+        &source_latitudes,
+        &source_longitudes,
+        &target_latitudes,
+        &target_longitudes
+    ](
+        const Trajectory::const_iterator source_iterator,
+        const Trajectory::const_iterator target_iterator
+    ) {
+        source_latitudes.push_back(source_iterator->latitude);
+        source_longitudes.push_back(source_iterator->longitude);
+        target_latitudes.push_back(target_iterator->latitude);
+        target_longitudes.push_back(target_iterator->longitude);
+
+        one_way_matched_sequence.temporal_distances.push_back(
+            (source_iterator->timestamp >= target_iterator->timestamp) ? (source_iterator->timestamp - target_iterator->timestamp) : (target_iterator->timestamp - source_iterator->timestamp)
+        );
+
+        one_way_matched_sequence.timestamps.push_back(target_iterator->timestamp);
+    };
+
+    find_closest_matches(
+        from,
+        to,
+        closest_match_consumer
+    );
+
+    one_way_matched_sequence.spatial_distances.resize(source_latitudes.size());
+    haversine_pairwise(
+        source_latitudes.data(),
+        source_longitudes.data(),
+        target_latitudes.data(),
+        target_longitudes.data(),
+        source_latitudes.size(),
+        one_way_matched_sequence.spatial_distances.data()
+    );
+
+    return one_way_matched_sequence;
+}
+
+MatchedSequences calculate_matched_sequences(
+    const Trajectory& first,
+    const Trajectory& second
+) {
+    return {
+        calculate_one_way_matched_sequence(first, second),
+        calculate_one_way_matched_sequence(second, first)
+    };
+}
+
+double one_way_trajectory_similarity(
+    const OneWayMatchedSequence& one_way_matched_sequence,
+    const double delta,
+    const double tau
+) {
+    double total_time = 0;
+    double total_area = 0;
+
+    const size_t number_of_matches = one_way_matched_sequence.timestamps.size();
+
+    double old_similarity = 0;
+    for (size_t i = 0; i < number_of_matches; ++i) {
+        double similarity = exp((-one_way_matched_sequence.spatial_distances[i] / delta) + (-one_way_matched_sequence.temporal_distances[i] / tau));
+
+        if (i) {
+            double time_delta = one_way_matched_sequence.timestamps[i] - one_way_matched_sequence.timestamps[i - 1];
+            double area_delta = (similarity + old_similarity) * time_delta / 2;
+            total_time += time_delta;
+            total_area += area_delta;
+        }
+
+        old_similarity = similarity;
+    }
+
+    return total_area / total_time;
+}
+
+// trajectory_similarity(first, second, delta, tau), given matched_sequences = calculate_matched_sequences(first, second),
+// up to the rounding of haversine_pairwise() on AVX2
+double trajectory_similarity(
+    const MatchedSequences& matched_sequences,
+    const double delta,
+    const double tau
+) {
+    return (one_way_trajectory_similarity(matched_sequences.first_to_second, delta, tau) + one_way_trajectory_similarity(matched_sequences.second_to_first, delta, tau)) / 2;
+}
+
+// Evaluates one_way_trajectory_similarity() for each (delta, tau) in delta_values x tau_values at once.
+// As exp(-d / delta - t / tau) = exp(-d / delta) * exp(-t / tau),
+// and the trapezoid rule is a weighted sum of the similarities of the matches,
+// the total areas are (spatial factors)^T * diag(trapezoid weights) * (temporal factors), a single matrix product.
+// The result is indexed by (delta index, tau index) and agrees with one_way_trajectory_similarity() up to rounding.
+Eigen::ArrayXXd one_way_trajectory_similarities(
+    const OneWayMatchedSequence& one_way_matched_sequence,
+    const Eigen::ArrayXd& delta_values,
+    const Eigen::ArrayXd& tau_values
+) {
+    const Eigen::Index number_of_matches = one_way_matched_sequence.timestamps.size();
+
+    const Eigen::Map<const Eigen::ArrayXd> spatial_distances(one_way_matched_sequence.spatial_distances.data(), number_of_matches);
+    const Eigen::Map<const Eigen::ArrayXd> temporal_distances(one_way_matched_sequence.temporal_distances.data(), number_of_matches);
+
+    double total_time = 0;
+    Eigen::VectorXd trapezoid_weights = Eigen::VectorXd::Zero(number_of_matches);
+    for (Eigen::Index i = 1; i < number_of_matches; ++i) {
+        double time_delta = one_way_matched_sequence.timestamps[i] - one_way_matched_sequence.timestamps[i - 1];
+        trapezoid_weights[i - 1] += time_delta / 2;
+        trapezoid_weights[i] += time_delta / 2;
+        total_time += time_delta;
+    }
+
+    Eigen::MatrixXd spatial_factors(number_of_matches, delta_values.size());
+    for (Eigen::Index delta_index = 0; delta_index < delta_values.size(); ++delta_index) {
+        spatial_factors.col(delta_index) = (-spatial_distances / delta_values[delta_index]).exp().matrix();
+    }
+
+    Eigen::MatrixXd temporal_factors(number_of_matches, tau_values.size());
+    for (Eigen::Index tau_index = 0; tau_index < tau_values.size(); ++tau_index) {
+        temporal_factors.col(tau_index) = (-temporal_distances / tau_values[tau_index]).exp().matrix();
+    }
+
+    const Eigen::MatrixXd total_areas = spatial_factors.transpose() * trapezoid_weights.asDiagonal() * temporal_factors;
+
+    return total_areas.array() / total_time;
+}
+
+// Evaluates trajectory_similarity() for each (delta, tau) in delta_values x tau_values, indexed by (delta index, tau index).
+Eigen::ArrayXXd trajectory_similarities(
+    const MatchedSequences& matched_sequences,
+    const Eigen::ArrayXd& delta_values,
+    const Eigen::ArrayXd& tau_values
+) {
+    return (one_way_trajectory_similarities(matched_sequences.first_to_second, delta_values, tau_values) + one_way_trajectory_similarities(matched_sequences.second_to_first, delta_values, tau_values)) / 2;
+}
+
 /*
 #include <math.h>
 
@@ -0,0 +1,120 @@
+#ifndef TRAJECTORY_STORE_HPP
+#define TRAJECTORY_STORE_HPP
+
+#include <math.h>
+#include <stddef.h>
+#include <time.h>
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "haversine.hpp"
+
+
+// A read-only view of the points of one trajectory in a TrajectoryStore.
+struct TrajectoryView {
+    const double* latitudes;
+    const double* longitudes;
+    const double* cos_latitudes;
+    const time_t* timestamps;
+    size_t number_of_points;
+
+    size_t size() const {
+        return number_of_points;
+    }
+
+    bool empty() const {
+        return number_of_points == 0;
+    }
+};
+
+
+// The trajectories of all users, with the points of user i in [begins[i], ends[i]) of each column.
+// Latitudes and longitudes stay in degrees, as haversine() subtracts them before converting to radians,
+// while cos(latitude in radians) is precomputed once per point instead of once per comparison.
+// The columns are either owned by the store or point into a memory-mapped trajectory file (see trajectory_store_file.hpp),
+// and storage keeps them alive for as long as any copy of the store exists.
+struct TrajectoryStore {
+    std::vector<size_t> begins;
+    std::vector<size_t> ends;
+    const double* latitudes = nullptr;
+    const double* longitudes = nullptr;
+    const double* cos_latitudes = nullptr;
+    const time_t* timestamps = nullptr;
+    std::shared_ptr<const void> storage;
+
+    struct Columns {
+        std::vector<double> latitudes;
+        std::vector<double> longitudes;
+        std::vector<double> cos_latitudes;
+        std::vector<time_t> timestamps;
+    };
+
+    TrajectoryStore() = default;
+
+    // builds the store from a map of user indices in [0, number_of_users) to trajectories, with user i stored before user i + 1
+    template <typename IndexToTrajectoryMap> TrajectoryStore(
+        const size_t number_of_users,
+        const IndexToTrajectoryMap& trajectory_dataset
+    ): begins(number_of_users, 0), ends(number_of_users, 0) {
+        std::vector<size_t> offsets(number_of_users + 1, 0);
+        for (const auto& index_and_trajectory: trajectory_dataset) {
+            offsets[index_and_trajectory.first + 1] = index_and_trajectory.second.size();
+        }
+
+        for (size_t index = 0; index < number_of_users; ++index) {
+            offsets[index + 1] += offsets[index];
+            begins[index] = offsets[index];
+            ends[index] = offsets[index + 1];
+        }
+
+        const size_t number_of_points = offsets[number_of_users];
+        std::shared_ptr<Columns> columns = std::make_shared<Columns>();
+        columns->latitudes.resize(number_of_points);
+        columns->longitudes.resize(number_of_points);
+        columns->cos_latitudes.resize(number_of_points);
+        columns->timestamps.resize(number_of_points);
+
+        for (const auto& index_and_trajectory: trajectory_dataset) {
+            size_t position = offsets[index_and_trajectory.first];
+
+            for (const auto& point: index_and_trajectory.second) {
+                columns->latitudes[position] = point.latitude;
+                columns->longitudes[position] = point.longitude;
+                columns->cos_latitudes[position] = cos(point.latitude * DEGREES_TO_RADIANS);
+                columns->timestamps[position] = point.timestamp;
+                ++position;
+            }
+        }
+
+        latitudes = columns->latitudes.data();
+        longitudes = columns->longitudes.data();
+        cos_latitudes = columns->cos_latitudes.data();
+        timestamps = columns->timestamps.data();
+        storage = std::move(columns);
+    }
+
+    size_t size() const {
+        return begins.size();
+    }
+
+    // like a map of user indices to trajectories, throws std::out_of_range for users without points
+    TrajectoryView at(const size_t index) const {
+        if (index >= size() || begins[index] == ends[index]) {
+            throw std::out_of_range("TrajectoryStore::at: no trajectory for user " + std::to_string(index));
+        }
+
+        return {
+            latitudes + begins[index],
+            longitudes + begins[index],
+            cos_latitudes + begins[index],
+            timestamps + begins[index],
+            ends[index] - begins[index]
+        };
+    }
+};
+
+#endif
@@ -0,0 +1,265 @@
+#ifndef TRAJECTORY_STORE_FILE_HPP
+#define TRAJECTORY_STORE_FILE_HPP
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include "haversine.hpp"
+#include "trajectory.h"
+#include "trajectory_store.hpp"
+
+
+// A binary trajectory file, in native byte order, laid out as
+//
+//     TrajectoryStoreFileHeader
+//     uint64_t name_offsets[number_of_users + 1]    user i is named names[name_offsets[i], name_offsets[i + 1])
+//     uint64_t offsets[number_of_users + 1]         user i has the points [offsets[i], offsets[i + 1]) of each column
+//     char names[names_size]                        padded with zeros to a multiple of 8 bytes
+//     double latitudes[number_of_points]
+//     double longitudes[number_of_points]
+//     double cos_latitudes[number_of_points]
+//     int64_t timestamps[number_of_points]
+//
+// so that every array is 8-byte aligned in a memory mapping, and the columns can be used by a TrajectoryStore as they are.
+// The points of each user are in the order of the CSV file the trajectory file was converted from.
+
+static_assert(sizeof(time_t) == sizeof(int64_t), "trajectory files store timestamps as 64-bit integers");
+
+constexpr char TRAJECTORY_STORE_FILE_MAGIC[8] = { 'T', 'R', 'J', 'S', 'T', 'O', 'R', 'E' };
+constexpr uint64_t TRAJECTORY_STORE_FILE_VERSION = 1;
+
+struct TrajectoryStoreFileHeader {
+    char magic[8];
+    uint64_t version;
+    uint64_t number_of_users;
+    uint64_t number_of_points;
+    uint64_t names_size;
+};
+
+
+// whether the file at path starts with TRAJECTORY_STORE_FILE_MAGIC, as opposed to, e.g., a CSV file
+inline bool is_trajectory_store_file(const std::string& path) {
+    std::ifstream input_file_stream(path, std::ios::binary);
+
+    char magic[sizeof(TRAJECTORY_STORE_FILE_MAGIC)];
+    if (!input_file_stream.read(magic, sizeof(magic))) return false;
+
+    return memcmp(magic, TRAJECTORY_STORE_FILE_MAGIC, sizeof(magic)) == 0;
+}
+
+
+// write the trajectories of users named user_names[i] to a trajectory file
+inline void write_trajectory_store_file(
+    const std::string& path,
+    const std::vector<std::string>& user_names,
+    const std::vector<Trajectory>& trajectories
+) {
+    const size_t number_of_users = user_names.size();
+
+    std::vector<uint64_t> name_offsets(number_of_users + 1, 0);
+    std::vector<uint64_t> offsets(number_of_users + 1, 0);
+    for (size_t user = 0; user < number_of_users; ++user) {
+        name_offsets[user + 1] = name_offsets[user] + user_names[user].size();
+        offsets[user + 1] = offsets[user] + trajectories[user].size();
+    }
+
+    const uint64_t number_of_points = offsets[number_of_users];
+
+    TrajectoryStoreFileHeader header;
+    memcpy(header.magic, TRAJECTORY_STORE_FILE_MAGIC, sizeof(header.magic));
+    header.version = TRAJECTORY_STORE_FILE_VERSION;
+    header.number_of_users = number_of_users;
+    header.number_of_points = number_of_points;
+    header.names_size = (name_offsets[number_of_users] + 7) / 8 * 8;
+
+    std::vector<char> names(header.names_size, 0);
+    for (size_t user = 0; user < number_of_users; ++user) {
+        memcpy(names.data() + name_offsets[user], user_names[user].data(), user_names[user].size());
+    }
+
+    std::vector<double> latitudes, longitudes, cos_latitudes;
+    std::vector<int64_t> timestamps;
+    latitudes.reserve(number_of_points);
+    longitudes.reserve(number_of_points);
+    cos_latitudes.reserve(number_of_points);
+    timestamps.reserve(number_of_points);
+
+    for (const Trajectory& trajectory: trajectories) {
+        for (const Point& point: trajectory) {
+            latitudes.push_back(point.latitude);
+            longitudes.push_back(point.longitude);
+            cos_latitudes.push_back(cos(point.latitude * DEGREES_TO_RADIANS));
+            timestamps.push_back(point.timestamp);
+        }
+    }
+
+    std::ofstream output_file_stream(path, std::ios::binary);
+
+    const auto write_array = [&output_file_stream](const auto& array) {
+        output_file_stream.write(
+            reinterpret_cast<const char*>(array.data()),
+            array.size() * sizeof(array[0])
+        );
+    };
+
+    output_file_stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    write_array(name_offsets);
+    write_array(offsets);
+    write_array(names);
+    write_array(latitudes);
+    write_array(longitudes);
+    write_array(cos_latitudes);
+    write_array(timestamps);
+
+    if (!output_file_stream) {
+        throw std::runtime_error("write_trajectory_store_file: cannot write " + path);
+    }
+}
+
+
+// A trajectory file mapped into memory read-only, with pointers to its arrays.
+struct TrajectoryStoreFile {
+    boost::interprocess::file_mapping file_mapping;
+    boost::interprocess::mapped_region mapped_region;
+
+    size_t number_of_users;
+    size_t number_of_points;
+    const uint64_t* name_offsets;
+    const uint64_t* offsets;
+    const char* names;
+    const double* latitudes;
+    const double* longitudes;
+    const double* cos_latitudes;
+    const time_t* timestamps;
+
+    // throws std::runtime_error if the file is not a trajectory file or is truncated
+    explicit TrajectoryStoreFile(const std::string& path):
+        file_mapping(path.c_str(), boost::interprocess::read_only),
+        mapped_region(file_mapping, boost::interprocess::read_only) {
+        const char* begin = static_cast<const char*>(mapped_region.get_address());
+        const size_t size = mapped_region.get_size();
+
+        TrajectoryStoreFileHeader header;
+        if (size < sizeof(header)) {
+            throw std::runtime_error("TrajectoryStoreFile: " + path + " is too small to be a trajectory file");
+        }
+        memcpy(&header, begin, sizeof(header));
+
+        if (memcmp(header.magic, TRAJECTORY_STORE_FILE_MAGIC, sizeof(header.magic)) != 0) {
+            throw std::runtime_error("TrajectoryStoreFile: " + path + " is not a trajectory file");
+        }
+        if (header.version != TRAJECTORY_STORE_FILE_VERSION) {
+            throw std::runtime_error("TrajectoryStoreFile: " + path + " has unsupported version " + std::to_string(header.version));
+        }
+
+        number_of_users = header.number_of_users;
+        number_of_points = header.number_of_points;
+
+        // bound the counts by the file size before multiplying them, so that a corrupt header cannot overflow expected_size
+        if (
+            number_of_users >= size / (2 * sizeof(uint64_t))
+            || header.names_size > size
+            || number_of_points > size / (3 * sizeof(double) + sizeof(int64_t))
+        ) {
+            throw std::runtime_error("TrajectoryStoreFile: " + path + " has a header with more users, names, or points than fit in it");
+        }
+
+        const size_t expected_size = sizeof(header)
+            + 2 * (number_of_users + 1) * sizeof(uint64_t)
+            + header.names_size
+            + number_of_points * (3 * sizeof(double) + sizeof(int64_t));
+        if (size != expected_size) {
+            throw std::runtime_error("TrajectoryStoreFile: " + path + " has " + std::to_string(size) + " bytes instead of " + std::to_string(expected_size));
+        }
+
+        const char* position = begin + sizeof(header);
+        name_offsets = reinterpret_cast<const uint64_t*>(position);
+        position += (number_of_users + 1) * sizeof(uint64_t);
+        offsets = reinterpret_cast<const uint64_t*>(position);
+        position += (number_of_users + 1) * sizeof(uint64_t);
+        names = position;
+        position += header.names_size;
+        latitudes = reinterpret_cast<const double*>(position);
+        position += number_of_points * sizeof(double);
+        longitudes = reinterpret_cast<const double*>(position);
+        position += number_of_points * sizeof(double);
+        cos_latitudes = reinterpret_cast<const double*>(position);
+        position += number_of_points * sizeof(double);
+        timestamps = reinterpret_cast<const time_t*>(position);
+
+        // the offsets must ascend from 0 to the end of names and the points, so that every user's range lies within them
+        bool is_consistent = name_offsets[0] == 0 && offsets[0] == 0
+            && name_offsets[number_of_users] <= header.names_size && offsets[number_of_users] == number_of_points;
+        for (size_t user = 0; is_consistent && user < number_of_users; ++user) {
+            is_consistent = name_offsets[user] <= name_offsets[user + 1] && offsets[user] <= offsets[user + 1];
+        }
+
+        if (!is_consistent) {
+            throw std::runtime_error("TrajectoryStoreFile: " + path + " has inconsistent offsets");
+        }
+    }
+
+    std::string_view get_user_name(const size_t user) const {
+        return std::string_view(names + name_offsets[user], name_offsets[user + 1] - name_offsets[user]);
+    }
+
+    Trajectory get_trajectory(const size_t user) const {
+        Trajectory trajectory;
+        trajectory.reserve(offsets[user + 1] - offsets[user]);
+
+        for (size_t position = offsets[user]; position < offsets[user + 1]; ++position) {
+            trajectory.push_back({ latitudes[position], longitudes[position], timestamps[position] });
+        }
+
+        return trajectory;
+    }
+};
+
+
+// map a trajectory file into a TrajectoryStore indexed by vertex descriptor, without copying any points;
+// users not in string_to_vertex_descriptor_map are ignored, and vertices without a user have no trajectory
+template <typename StringToVertexDescriptorMap> TrajectoryStore map_trajectory_store_file(
+    const StringToVertexDescriptorMap& string_to_vertex_descriptor_map,
+    const size_t number_of_vertices,
+    const std::string& trajectory_store_file_path
+) {
+    std::shared_ptr<const TrajectoryStoreFile> trajectory_store_file = std::make_shared<const TrajectoryStoreFile>(trajectory_store_file_path);
+
+    TrajectoryStore trajectory_store;
+    trajectory_store.begins.assign(number_of_vertices, 0);
+    trajectory_store.ends.assign(number_of_vertices, 0);
+
+    std::string user_name;
+    for (size_t user = 0; user < trajectory_store_file->number_of_users; ++user) {
+        user_name = trajectory_store_file->get_user_name(user);
+
+        const auto iterator = string_to_vertex_descriptor_map.find(user_name);
+        if (iterator == string_to_vertex_descriptor_map.end()) continue;
+
+        trajectory_store.begins[iterator->second] = trajectory_store_file->offsets[user];
+        trajectory_store.ends[iterator->second] = trajectory_store_file->offsets[user + 1];
+    }
+
+    trajectory_store.latitudes = trajectory_store_file->latitudes;
+    trajectory_store.longitudes = trajectory_store_file->longitudes;
+    trajectory_store.cos_latitudes = trajectory_store_file->cos_latitudes;
+    trajectory_store.timestamps = trajectory_store_file->timestamps;
+    trajectory_store.storage = std::move(trajectory_store_file);
+
+    return trajectory_store;
+}
+
+#endif
@@ -0,0 +1,41 @@
+#ifndef VERTEX_INDEXED_TRAJECTORY_DATASET_HPP
+#define VERTEX_INDEXED_TRAJECTORY_DATASET_HPP
+
+#include <stddef.h>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "trajectory.h"
+
+
+// The trajectories of the vertices of a vecS graph in a vector indexed by vertex descriptor,
+// in place of a vertex descriptor to trajectory map.
+// Like such a map, operator[] accesses the trajectory of a vertex (e.g., for load_trajectory_dataset()),
+// and at() throws std::out_of_range for vertices without points.
+struct VertexIndexedTrajectoryDataset {
+    std::vector<Trajectory> trajectories;
+
+    VertexIndexedTrajectoryDataset() = default;
+
+    explicit VertexIndexedTrajectoryDataset(const size_t number_of_vertices): trajectories(number_of_vertices) { }
+
+    size_t size() const {
+        return trajectories.size();
+    }
+
+    Trajectory& operator[](const size_t vertex_descriptor) {
+        return trajectories[vertex_descriptor];
+    }
+
+    const Trajectory& at(const size_t vertex_descriptor) const {
+        if (vertex_descriptor >= trajectories.size() || trajectories[vertex_descriptor].empty()) {
+            throw std::out_of_range("VertexIndexedTrajectoryDataset::at: no trajectory for vertex " + std::to_string(vertex_descriptor));
+        }
+
+        return trajectories[vertex_descriptor];
+    }
+};
+
+#endif
@@ -1,8 +1,16 @@
+#include <stdint.h>
+#include <string.h>
+
 #include <algorithm>
+#include <atomic>
+#include <cmath>
 #include <fstream>
 #include <iostream>
 #include <limits>
+#include <memory>
 #include <numeric>
+#include <random>
+#include <stdexcept>
 #include <string>
 #include <thread>
 #include <tuple>
@@ -13,59 +21,245 @@
 #include <boost/asio/thread_pool.hpp>
 #include <boost/graph/adjacency_list.hpp>
 #include <boost/graph/connected_components.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
 #include <boost/property_map/property_map.hpp>
-#include <boost/unordered_set.hpp>
 #include <boost/unordered_map.hpp>
 
 #include <pybind11/functional.h>
+#include <pybind11/numpy.h>
 #include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
 #include <pybind11/stl_bind.h>
 
-#include "experimental_code/read_adjacency_list.hpp"
+#include "experimental_code/csr_graph.hpp"
+#include "experimental_code/multi_source_breadth_first_search.hpp"
 #include "experimental_code/sizes_to_offsets.hpp"
+#include "experimental_code/split_into_chunks_of_similar_cost.hpp"
 
 
 // Graph typedefs
-typedef boost::adjacency_list<
-    boost::vecS,
-    boost::vecS,
-    boost::undirectedS,
-    boost::property<boost::vertex_name_t, std::string>
-> Graph;
+typedef CSRGraph Graph;
 typedef boost::graph_traits<Graph>::vertex_descriptor VertexDescriptor;
 typedef boost::graph_traits<Graph>::edge_descriptor EdgeDescriptor;
 typedef boost::graph_traits<Graph>::vertex_iterator VertexIterator;
 typedef boost::graph_traits<Graph>::adjacency_iterator AdjacencyIterator;
 
 
-struct GraphDistance {
+// writes graph_distance_oracle.get_distance(first_vertex_descriptors[i], second_vertex_descriptors[i]) to distances[i]
+// for each of the number_of_pairs pairs, splitting batches of more than minimum_number_of_pairs_per_task pairs
+// into contiguous ranges computed in parallel, for any oracle with a graph and a thread-safe get_distance() (e.g., GraphDistance).
+// Throws std::out_of_range if a vertex descriptor is not a vertex of the oracle's graph.
+template <typename GraphDistanceOracle, typename Index> void get_distances_of_pairs(
+    const GraphDistanceOracle& graph_distance_oracle,
+    const Index* first_vertex_descriptors,
+    const Index* second_vertex_descriptors,
+    const size_t number_of_pairs,
+    double* distances
+) {
+    const size_t number_of_vertices = boost::num_vertices(graph_distance_oracle.graph);
+    for (size_t pair_index = 0; pair_index < number_of_pairs; ++pair_index) {
+        if (
+            first_vertex_descriptors[pair_index] < 0 || static_cast<size_t>(first_vertex_descriptors[pair_index]) >= number_of_vertices
+            || second_vertex_descriptors[pair_index] < 0 || static_cast<size_t>(second_vertex_descriptors[pair_index]) >= number_of_vertices
+        ) {
+            throw std::out_of_range("get_distances_of_pairs: a vertex index is not a vertex of the graph");
+        }
+    }
+
+    const auto get_distances_of_range = [
+        &graph_distance_oracle,
+        first_vertex_descriptors,
+        second_vertex_descriptors,
+        distances
+    ](const size_t inclusive_start_pair, const size_t exclusive_end_pair) {
+        for (size_t pair_index = inclusive_start_pair; pair_index < exclusive_end_pair; ++pair_index) {
+            distances[pair_index] = graph_distance_oracle.get_distance(first_vertex_descriptors[pair_index], second_vertex_descriptors[pair_index]);
+        }
+    };
+
+    const size_t minimum_number_of_pairs_per_task = 1 << 16;
+    const size_t number_of_tasks = std::min<size_t>(
+        std::max(std::thread::hardware_concurrency(), 1u),
+        number_of_pairs / minimum_number_of_pairs_per_task
+    );
+
+    if (number_of_tasks < 2) {
+        get_distances_of_range(0, number_of_pairs);
+        return;
+    }
+
+    boost::asio::thread_pool thread_pool(number_of_tasks);
+
+    for (size_t task_index = 0; task_index < number_of_tasks; ++task_index) {
+        const size_t inclusive_start_pair = number_of_pairs * task_index / number_of_tasks;
+        const size_t exclusive_end_pair = number_of_pairs * (task_index + 1) / number_of_tasks;
+
+        boost::asio::post(
+            thread_pool,
+            [&get_distances_of_range, inclusive_start_pair, exclusive_end_pair]() {
+                get_distances_of_range(inclusive_start_pair, exclusive_end_pair);
+            }
+        );
+    }
+
+    thread_pool.join();
+}
+
+
+// A binary file of a GraphDistance, in native byte order, laid out as
+//
+//     GraphDistanceFileHeader
+//     a CSR graph file of graph (see csr_graph_file.hpp)                       csr_graph_file_size bytes, a multiple of 8
+//     uint64_t size_of_connected_components[number_of_connected_components]
+//     uint64_t pairwise_index_offsets_of_connected_components[number_of_connected_components]
+//     uint32_t vertex_descriptor_to_connected_component_index_map[number_of_vertices]
+//     uint32_t vertex_descriptor_to_index_map[number_of_vertices]
+//     Distance pairwise_distances[number_of_pairwise_distances]                distance_size bytes each
+//
+// so that every array is aligned when the file is mapped, and GraphDistance::load() points into the mapping without copying it.
+
+const char GRAPH_DISTANCE_FILE_MAGIC[8] = { 'G', 'R', 'A', 'P', 'H', 'D', 'S', 'T' };
+const uint64_t GRAPH_DISTANCE_FILE_VERSION = 1;
+
+struct GraphDistanceFileHeader {
+    char magic[8];
+    uint64_t version;
+    uint64_t distance_size;
+    uint64_t csr_graph_file_size;
+    uint64_t number_of_vertices;
+    uint64_t number_of_connected_components;
+    uint64_t number_of_pairwise_distances;
+};
+
+// A graph distance file mapped into memory read-only, with pointers to its tables (the CSR graph file is mapped by map_csr_graph_file()).
+struct GraphDistanceFile {
+    boost::interprocess::file_mapping file_mapping;
+    boost::interprocess::mapped_region mapped_region;
+
+    GraphDistanceFileHeader header;
+    const uint64_t* size_of_connected_components;
+    const uint64_t* pairwise_index_offsets_of_connected_components;
+    const uint32_t* vertex_descriptor_to_connected_component_index_map;
+    const uint32_t* vertex_descriptor_to_index_map;
+    const char* pairwise_distances;
+
+    // throws std::runtime_error if the file is not a graph distance file or is truncated
+    explicit GraphDistanceFile(const std::string& path):
+        file_mapping(path.c_str(), boost::interprocess::read_only),
+        mapped_region(file_mapping, boost::interprocess::read_only) {
+        const char* begin = static_cast<const char*>(mapped_region.get_address());
+        const size_t size = mapped_region.get_size();
+
+        if (size < sizeof(header)) {
+            throw std::runtime_error("GraphDistanceFile: " + path + " is too small to be a graph distance file");
+        }
+        memcpy(&header, begin, sizeof(header));
+
+        if (memcmp(header.magic, GRAPH_DISTANCE_FILE_MAGIC, sizeof(header.magic)) != 0) {
+            throw std::runtime_error("GraphDistanceFile: " + path + " is not a graph distance file");
+        }
+        if (header.version != GRAPH_DISTANCE_FILE_VERSION) {
+            throw std::runtime_error("GraphDistanceFile: " + path + " has unsupported version " + std::to_string(header.version));
+        }
+
+        // bound the sizes by the file size before multiplying them, so that a corrupt header cannot overflow expected_size
+        if (
+            header.csr_graph_file_size > size
+            || header.number_of_connected_components > size / (2 * sizeof(uint64_t))
+            || header.number_of_vertices > size / (2 * sizeof(uint32_t))
+            || header.distance_size == 0
+            || header.number_of_pairwise_distances > size / header.distance_size
+        ) {
+            throw std::runtime_error("GraphDistanceFile: " + path + " has a header with more tables than fit in it");
+        }
+
+        // the tables after the CSR graph file hold uint64_t and uint32_t values, so they must start 8-byte aligned
+        if (header.csr_graph_file_size % 8 != 0) {
+            throw std::runtime_error("GraphDistanceFile: " + path + " has a CSR graph file of " + std::to_string(header.csr_graph_file_size) + " bytes, not a multiple of 8");
+        }
+
+        const size_t expected_size = sizeof(header)
+            + header.csr_graph_file_size
+            + 2 * header.number_of_connected_components * sizeof(uint64_t)
+            + 2 * header.number_of_vertices * sizeof(uint32_t)
+            + header.number_of_pairwise_distances * header.distance_size;
+        if (size != expected_size) {
+            throw std::runtime_error("GraphDistanceFile: " + path + " has " + std::to_string(size) + " bytes instead of " + std::to_string(expected_size));
+        }
+
+        const char* position = begin + sizeof(header) + header.csr_graph_file_size;
+        size_of_connected_components = reinterpret_cast<const uint64_t*>(position);
+        position += header.number_of_connected_components * sizeof(uint64_t);
+        pairwise_index_offsets_of_connected_components = reinterpret_cast<const uint64_t*>(position);
+        position += header.number_of_connected_components * sizeof(uint64_t);
+        vertex_descriptor_to_connected_component_index_map = reinterpret_cast<const uint32_t*>(position);
+        position += header.number_of_vertices * sizeof(uint32_t);
+        vertex_descriptor_to_index_map = reinterpret_cast<const uint32_t*>(position);
+        position += header.number_of_vertices * sizeof(uint32_t);
+        pairwise_distances = position;
+    }
+};
+
+
+// The tables of a GraphDistance, built in memory
+template <typename Distance> struct GraphDistanceArrays {
+    std::vector<uint64_t> size_of_connected_components;
+    std::vector<uint64_t> pairwise_index_offsets_of_connected_components;
+    std::vector<uint32_t> vertex_descriptor_to_connected_component_index_map;
+    std::vector<uint32_t> vertex_descriptor_to_index_map;
+    std::vector<Distance> pairwise_distances;
+};
+
+
+// Stores the hop distance of every pair of vertices in the same connected component in a Distance (e.g., uint8_t or uint16_t),
+// whose maximum value is the sentinel unreachable_distance, so a hop count must be below it to be stored.
+// The tables are either owned by the GraphDistance or point into a file mapped by load(), and storage keeps them alive.
+template <typename Distance> struct GraphDistance {
+    static const Distance unreachable_distance = std::numeric_limits<Distance>::max();
+
     Graph graph;
     boost::unordered_map<std::string, VertexDescriptor> string_to_vertex_descriptor_map;
-    boost::unordered_map<VertexDescriptor, size_t> vertex_descriptor_to_connected_component_index_map;
-    std::vector<size_t> size_of_connected_components;
-    boost::unordered_map<VertexDescriptor, size_t> vertex_descriptor_to_index_map;
-    std::vector<size_t> pairwise_index_offsets_of_connected_components;
-    std::vector<double> pairwise_distances;
+    size_t number_of_connected_components = 0;
+    size_t number_of_pairwise_distances = 0;
+    const uint32_t* vertex_descriptor_to_connected_component_index_map = nullptr;
+    const uint64_t* size_of_connected_components = nullptr;
+    const uint32_t* vertex_descriptor_to_index_map = nullptr;
+    const uint64_t* pairwise_index_offsets_of_connected_components = nullptr;
+    const Distance* pairwise_distances = nullptr;
+    std::shared_ptr<const void> storage;
+
+    GraphDistance() {}
 
-    GraphDistance(
+    explicit GraphDistance(
         const std::string& input_graph_path
     ) {
         // load graph and string_to_vertex_descriptor_map
-        std::ifstream input_file_stream(input_graph_path);
-        read_adjacency_list<boost::vertex_name_t>(
-            graph,
+        graph = load_csr_graph(
             string_to_vertex_descriptor_map,
-            input_file_stream
+            input_graph_path
         );
 
+        const size_t number_of_vertices = boost::num_vertices(graph);
+
+        std::shared_ptr<GraphDistanceArrays<Distance>> graph_distance_arrays = std::make_shared<GraphDistanceArrays<Distance>>();
+
         // initialize vertex_descriptor_to_connected_component_index_map
-        const size_t number_of_connected_components = boost::connected_components(graph, boost::make_assoc_property_map(vertex_descriptor_to_connected_component_index_map));
+        graph_distance_arrays->vertex_descriptor_to_connected_component_index_map.resize(number_of_vertices);
+        number_of_connected_components = boost::connected_components(
+            graph,
+            boost::make_iterator_property_map(
+                graph_distance_arrays->vertex_descriptor_to_connected_component_index_map.begin(),
+                boost::get(boost::vertex_index, graph)
+            )
+        );
 
         // initialize size_of_connected_components, vertex_descriptor_to_index_map
-        size_of_connected_components.resize(
+        graph_distance_arrays->size_of_connected_components.resize(
             number_of_connected_components,
             0
         );
+        graph_distance_arrays->vertex_descriptor_to_index_map.resize(number_of_vertices);
 
         VertexIterator vertex_iterator, vertex_end;
         for (
@@ -74,107 +268,307 @@ struct GraphDistance {
             ++vertex_iterator
         ) {
             const VertexDescriptor& vertex_descriptor = *vertex_iterator;
-            const size_t connected_component_index = vertex_descriptor_to_connected_component_index_map.at(vertex_descriptor);
+            const size_t connected_component_index = graph_distance_arrays->vertex_descriptor_to_connected_component_index_map[vertex_descriptor];
 
-            vertex_descriptor_to_index_map[vertex_descriptor] = size_of_connected_components.at(connected_component_index);
-            ++size_of_connected_components.at(connected_component_index);
+            graph_distance_arrays->vertex_descriptor_to_index_map[vertex_descriptor] = graph_distance_arrays->size_of_connected_components[connected_component_index];
+            ++graph_distance_arrays->size_of_connected_components[connected_component_index];
         }
 
         // initialize number_of_pairs_in_connected_components
-        std::vector<size_t> number_of_pairs_in_connected_components;
+        std::vector<uint64_t> number_of_pairs_in_connected_components;
         std::transform(
-            size_of_connected_components.cbegin(),
-            size_of_connected_components.cend(),
+            graph_distance_arrays->size_of_connected_components.cbegin(),
+            graph_distance_arrays->size_of_connected_components.cend(),
             std::back_inserter(number_of_pairs_in_connected_components),
-            [](const size_t number) { return number * (number - 1) / 2; }
+            [](const uint64_t number) { return number * (number - 1) / 2; }
         );
 
         // initialize pairwise_index_offsets_of_connected_components
-        pairwise_index_offsets_of_connected_components = sizes_to_offsets(number_of_pairs_in_connected_components);
+        graph_distance_arrays->pairwise_index_offsets_of_connected_components = sizes_to_offsets(number_of_pairs_in_connected_components);
 
         // allocate space for pairwise_distances
-        pairwise_distances.resize(
-            std::accumulate(number_of_pairs_in_connected_components.cbegin(), number_of_pairs_in_connected_components.cend(), 0),
-            std::numeric_limits<double>::infinity()
+        number_of_pairwise_distances = std::accumulate(number_of_pairs_in_connected_components.cbegin(), number_of_pairs_in_connected_components.cend(), uint64_t(0));
+        graph_distance_arrays->pairwise_distances.resize(
+            number_of_pairwise_distances,
+            unreachable_distance
         );
 
-        // initialize thread_pool
-	    boost::asio::thread_pool thread_pool(std::thread::hardware_concurrency());
-        
+        // the tables are not resized from here on, so the pointers to them stay valid, and the sweeps write through writable_pairwise_distances
+        Distance* writable_pairwise_distances = graph_distance_arrays->pairwise_distances.data();
+        point_to_graph_distance_arrays(graph_distance_arrays);
+
+        // relabel the vertices so that each connected component occupies a contiguous range of vertices in the order of their indices,
+        // and lay out the adjacency in CSR form over the relabelled vertices, naming each neighbor by its index in its connected component,
+        // so that a breadth-first search within a connected component only touches the words of that connected component
+        const std::vector<uint64_t> first_vertex_of_connected_components = sizes_to_offsets(graph_distance_arrays->size_of_connected_components);
+
+        std::vector<size_t> vertex_descriptor_to_relabelled_vertex_map(number_of_vertices);
+        std::vector<uint64_t> relabelled_offsets(number_of_vertices + 1, 0);
+        for (
+            std::tie(vertex_iterator, vertex_end) = boost::vertices(graph);
+            vertex_iterator != vertex_end;
+            ++vertex_iterator
+        ) {
+            const VertexDescriptor& vertex_descriptor = *vertex_iterator;
+            const size_t relabelled_vertex = first_vertex_of_connected_components[vertex_descriptor_to_connected_component_index_map[vertex_descriptor]]
+                + vertex_descriptor_to_index_map[vertex_descriptor];
+
+            vertex_descriptor_to_relabelled_vertex_map[vertex_descriptor] = relabelled_vertex;
+            relabelled_offsets[relabelled_vertex + 1] = boost::degree(vertex_descriptor, graph);
+        }
+        std::partial_sum(relabelled_offsets.begin(), relabelled_offsets.end(), relabelled_offsets.begin());
+
+        std::vector<uint32_t> relabelled_neighbors(relabelled_offsets.back());
         for (
-            auto iterator = vertex_descriptor_to_index_map.cbegin();
-            iterator != vertex_descriptor_to_index_map.cend();
-            ++iterator
+            std::tie(vertex_iterator, vertex_end) = boost::vertices(graph);
+            vertex_iterator != vertex_end;
+            ++vertex_iterator
         ) {
-            const VertexDescriptor& bfs_tree_root = iterator->first;
-            const size_t& bfs_tree_root_index = iterator->second;
-            const size_t& connected_component_index = vertex_descriptor_to_connected_component_index_map.at(bfs_tree_root);
-            const size_t& connected_component_size = size_of_connected_components.at(connected_component_index);
-            const size_t& pairwise_index_offset = pairwise_index_offsets_of_connected_components.at(connected_component_index);
-
-            // https://networkx.org/documentation/networkx-1.10/_modules/networkx/algorithms/shortest_paths/unweighted.html#all_pairs_shortest_path_length
-            // https://en.wikipedia.org/wiki/Breadth-first_search
-            const auto bfs_task = [
+            uint64_t position = relabelled_offsets[vertex_descriptor_to_relabelled_vertex_map[*vertex_iterator]];
+
+            AdjacencyIterator adjacency_iterator, adjacency_end;
+            for (
+                std::tie(adjacency_iterator, adjacency_end) = boost::adjacent_vertices(*vertex_iterator, graph);
+                adjacency_iterator != adjacency_end;
+                ++adjacency_iterator
+            ) {
+                relabelled_neighbors[position++] = vertex_descriptor_to_index_map[*adjacency_iterator];
+            }
+        }
+
+        // each sweep breadth-first searches from NUMBER_OF_SOURCES_PER_SWEEP consecutive indices of a connected component at once
+        std::vector<std::pair<size_t, size_t>> connected_component_index_and_first_source_of_sweeps;
+        for (size_t connected_component_index = 0; connected_component_index < number_of_connected_components; ++connected_component_index) {
+            for (
+                size_t first_source = 0;
+                first_source + 1 < size_of_connected_components[connected_component_index];
+                first_source += NUMBER_OF_SOURCES_PER_SWEEP
+            ) {
+                connected_component_index_and_first_source_of_sweeps.push_back(std::make_pair(connected_component_index, first_source));
+            }
+        }
+
+        // initialize thread_pool, and schedule the sweeps in chunks of similar cost,
+        // as a sweep over a small connected component costs far less than posting it on its own
+        const unsigned int number_of_threads = std::max(std::thread::hardware_concurrency(), 1u);
+        boost::asio::thread_pool thread_pool(number_of_threads);
+
+        // set by a sweep reaching a vertex at a distance Distance cannot store, which is reported once the sweeps have joined
+        std::atomic<bool> is_distance_overflowed(false);
+
+        const std::vector<size_t> chunk_offsets = split_into_chunks_of_similar_cost(
+            connected_component_index_and_first_source_of_sweeps.size(),
+            [
                 this,
-                bfs_tree_root,
-                bfs_tree_root_index,
-                connected_component_size,
-                pairwise_index_offset
-            ]() {
-                // label root as explored
-                boost::unordered_set<VertexDescriptor> explored {bfs_tree_root};
+                &connected_component_index_and_first_source_of_sweeps,
+                &first_vertex_of_connected_components,
+                &relabelled_offsets
+            ](const size_t sweep_index) {
+                const size_t connected_component_index = connected_component_index_and_first_source_of_sweeps[sweep_index].first;
+                const size_t first_vertex = first_vertex_of_connected_components[connected_component_index];
+                const size_t connected_component_size = size_of_connected_components[connected_component_index];
+
+                return (double)(connected_component_size + relabelled_offsets[first_vertex + connected_component_size] - relabelled_offsets[first_vertex]);
+            },
+            8 * number_of_threads
+        );
 
-                // Q.enqueue(root)
-                std::vector<VertexDescriptor> current_layer {bfs_tree_root};
-                unsigned long level = 0;
+        for (size_t chunk_index = 0; chunk_index + 1 < chunk_offsets.size(); ++chunk_index) {
+            const size_t inclusive_start_sweep = chunk_offsets[chunk_index];
+            const size_t exclusive_end_sweep = chunk_offsets[chunk_index + 1];
 
-                // while Q is not empty do
-                while (current_layer.size()) {
-                    std::vector<VertexDescriptor> next_layer;
+            const auto sweep_task = [
+                this,
+                &connected_component_index_and_first_source_of_sweeps,
+                &first_vertex_of_connected_components,
+                &relabelled_offsets,
+                &relabelled_neighbors,
+                &is_distance_overflowed,
+                writable_pairwise_distances,
+                inclusive_start_sweep,
+                exclusive_end_sweep
+            ]() {
+                MultiSourceBreadthFirstSearchBuffers buffers;
+                uint32_t sources[NUMBER_OF_SOURCES_PER_SWEEP];
 
-                    for (const VertexDescriptor& vertex_descriptor: current_layer) {
-                        // v := Q.dequeue()
+                for (size_t sweep_index = inclusive_start_sweep; sweep_index < exclusive_end_sweep; ++sweep_index) {
+                    const size_t connected_component_index = connected_component_index_and_first_source_of_sweeps[sweep_index].first;
+                    const size_t first_source = connected_component_index_and_first_source_of_sweeps[sweep_index].second;
+                    const size_t connected_component_size = size_of_connected_components[connected_component_index];
+                    const size_t pairwise_index_offset = pairwise_index_offsets_of_connected_components[connected_component_index];
 
-                        // 存bfs_tree_root到vertex_descriptor的距离
-                        const size_t vertex_descriptor_index = vertex_descriptor_to_index_map.at(vertex_descriptor);
+                    const size_t number_of_sources = std::min(NUMBER_OF_SOURCES_PER_SWEEP, connected_component_size - first_source);
+                    for (size_t source_index = 0; source_index < number_of_sources; ++source_index) {
+                        sources[source_index] = first_source + source_index;
+                    }
 
-                        if (bfs_tree_root_index != vertex_descriptor_index) {
-                            pairwise_distances.at(pairwise_index_offset + vertex_descriptor_index_to_pairwise_index(bfs_tree_root_index, vertex_descriptor_index, connected_component_size)) = level;
+                    // a pair is only written by the sweep of its smaller index, i.e., each pair is written once
+                    const auto write_pairwise_distances = [
+                        this,
+                        &is_distance_overflowed,
+                        writable_pairwise_distances,
+                        first_source,
+                        connected_component_size,
+                        pairwise_index_offset
+                    ](const uint32_t index, uint64_t reached_sources, const size_t distance) {
+                        if (index <= first_source) {
+                            return;
+                        }
+                        if (index - first_source < NUMBER_OF_SOURCES_PER_SWEEP) {
+                            reached_sources &= (uint64_t(1) << (index - first_source)) - 1;
                         }
 
-                        // for all edges from v to w in G.adjacentEdges(v) do
-                        AdjacencyIterator adjacency_iterator, adjacency_end;
-                        for (
-                            std::tie(adjacency_iterator, adjacency_end) = boost::adjacent_vertices(vertex_descriptor, graph);
-                            adjacency_iterator != adjacency_end;
-                            ++adjacency_iterator
-                        ) {
-                            const VertexDescriptor& adjacency = *adjacency_iterator;
-
-                            // if w is not labeled as explored then
-                            if (!explored.count(adjacency)) {
-                                // label w as explored
-                                explored.insert(adjacency);
-
-                                // Q.enqueue(w)
-                                next_layer.push_back(adjacency);
-                            }
+                        if (distance >= unreachable_distance) {
+                            is_distance_overflowed.store(true, std::memory_order_relaxed);
+                            return;
                         }
-                    }
 
-                    current_layer = std::move(next_layer);
-                    ++level;
+                        while (reached_sources) {
+                            const size_t source_index = first_source + __builtin_ctzll(reached_sources);
+                            reached_sources &= reached_sources - 1;
+
+                            writable_pairwise_distances[pairwise_index_offset + vertex_descriptor_index_to_pairwise_index(source_index, index, connected_component_size)] = static_cast<Distance>(distance);
+                        }
+                    };
+
+                    multi_source_breadth_first_search(
+                        connected_component_size,
+                        relabelled_offsets.data() + first_vertex_of_connected_components[connected_component_index],
+                        relabelled_neighbors.data(),
+                        sources,
+                        number_of_sources,
+                        buffers,
+                        write_pairwise_distances
+                    );
                 }
             };
 
             boost::asio::post(
                 thread_pool,
-                bfs_task
+                sweep_task
             );
         }
 
         // join thread_pool
         thread_pool.join();
+
+        if (is_distance_overflowed.load(std::memory_order_relaxed)) {
+            throw std::overflow_error("GraphDistance: a distance does not fit in the distance type, use a wider one");
+        }
+    }
+
+    // points the tables to graph_distance_arrays, which storage keeps alive
+    void point_to_graph_distance_arrays(const std::shared_ptr<const GraphDistanceArrays<Distance>>& graph_distance_arrays) {
+        vertex_descriptor_to_connected_component_index_map = graph_distance_arrays->vertex_descriptor_to_connected_component_index_map.data();
+        size_of_connected_components = graph_distance_arrays->size_of_connected_components.data();
+        vertex_descriptor_to_index_map = graph_distance_arrays->vertex_descriptor_to_index_map.data();
+        pairwise_index_offsets_of_connected_components = graph_distance_arrays->pairwise_index_offsets_of_connected_components.data();
+        pairwise_distances = graph_distance_arrays->pairwise_distances.data();
+        storage = graph_distance_arrays;
+    }
+
+    // writes graph and the tables to a graph distance file at path, which load() maps back
+    void save(const std::string& path) const {
+        GraphDistanceFileHeader header;
+        memcpy(header.magic, GRAPH_DISTANCE_FILE_MAGIC, sizeof(header.magic));
+        header.version = GRAPH_DISTANCE_FILE_VERSION;
+        header.distance_size = sizeof(Distance);
+        header.csr_graph_file_size = 0;
+        header.number_of_vertices = boost::num_vertices(graph);
+        header.number_of_connected_components = number_of_connected_components;
+        header.number_of_pairwise_distances = number_of_pairwise_distances;
+
+        std::ofstream output_file_stream(path, std::ios::binary);
+
+        // the header is written again once the size of the CSR graph file is known
+        output_file_stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        write_csr_graph_file(graph, output_file_stream);
+        header.csr_graph_file_size = static_cast<uint64_t>(output_file_stream.tellp()) - sizeof(header);
+
+        write_csr_graph_file_array(output_file_stream, size_of_connected_components, number_of_connected_components);
+        write_csr_graph_file_array(output_file_stream, pairwise_index_offsets_of_connected_components, number_of_connected_components);
+        write_csr_graph_file_array(output_file_stream, vertex_descriptor_to_connected_component_index_map, header.number_of_vertices);
+        write_csr_graph_file_array(output_file_stream, vertex_descriptor_to_index_map, header.number_of_vertices);
+        write_csr_graph_file_array(output_file_stream, pairwise_distances, number_of_pairwise_distances);
+
+        output_file_stream.seekp(0);
+        output_file_stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+        if (!output_file_stream) {
+            throw std::runtime_error("GraphDistance::save: cannot write " + path);
+        }
+    }
+
+    // maps a graph distance file written by save() read-only, without copying the graph or the tables,
+    // so that it opens without any breadth-first search, and processes mapping the same file share its pages.
+    // Throws std::runtime_error if the file is not a graph distance file with distances of type Distance, or is truncated or inconsistent.
+    static GraphDistance load(const std::string& path) {
+        std::shared_ptr<const GraphDistanceFile> graph_distance_file = std::make_shared<const GraphDistanceFile>(path);
+        const GraphDistanceFileHeader& header = graph_distance_file->header;
+
+        if (header.distance_size != sizeof(Distance)) {
+            throw std::runtime_error("GraphDistance::load: " + path + " has distances of " + std::to_string(header.distance_size) + " bytes instead of " + std::to_string(sizeof(Distance)));
+        }
+
+        GraphDistance graph_distance;
+        graph_distance.graph = map_csr_graph_file(path, sizeof(header), header.csr_graph_file_size);
+
+        if (header.number_of_vertices != graph_distance.graph.number_of_vertices) {
+            throw std::runtime_error("GraphDistance::load: " + path + " has tables of " + std::to_string(header.number_of_vertices) + " vertices for a graph of " + std::to_string(graph_distance.graph.number_of_vertices));
+        }
+
+        // the tables must be those save() writes, so that every lookup of get_distance() stays within them:
+        // the sizes of the connected components add up to the number of vertices, the pairs of each connected component
+        // start at the total number of pairs of the previous ones and end within pairwise_distances,
+        // and each vertex has a connected component index and an index within that connected component in range
+        const uint64_t* size_of_connected_components = graph_distance_file->size_of_connected_components;
+        const uint64_t* pairwise_index_offsets_of_connected_components = graph_distance_file->pairwise_index_offsets_of_connected_components;
+
+        bool is_consistent = true;
+        uint64_t number_of_vertices_in_connected_components = 0;
+        uint64_t number_of_pairs_in_connected_components = 0;
+        for (size_t connected_component_index = 0; is_consistent && connected_component_index < header.number_of_connected_components; ++connected_component_index) {
+            const uint64_t connected_component_size = size_of_connected_components[connected_component_index];
+
+            is_consistent = connected_component_size > 0
+                && connected_component_size <= header.number_of_vertices - number_of_vertices_in_connected_components
+                && pairwise_index_offsets_of_connected_components[connected_component_index] == number_of_pairs_in_connected_components;
+
+            number_of_vertices_in_connected_components += connected_component_size;
+            number_of_pairs_in_connected_components += connected_component_size * (connected_component_size - 1) / 2;
+        }
+
+        is_consistent = is_consistent
+            && number_of_vertices_in_connected_components == header.number_of_vertices
+            && number_of_pairs_in_connected_components == header.number_of_pairwise_distances;
+
+        for (size_t vertex = 0; is_consistent && vertex < header.number_of_vertices; ++vertex) {
+            const uint32_t connected_component_index = graph_distance_file->vertex_descriptor_to_connected_component_index_map[vertex];
+
+            is_consistent = connected_component_index < header.number_of_connected_components
+                && graph_distance_file->vertex_descriptor_to_index_map[vertex] < size_of_connected_components[connected_component_index];
+        }
+
+        if (!is_consistent) {
+            throw std::runtime_error("GraphDistance::load: " + path + " has inconsistent connected component tables");
+        }
+
+        graph_distance.string_to_vertex_descriptor_map.reserve(graph_distance.graph.number_of_vertices);
+        for (uint32_t vertex = 0; vertex < graph_distance.graph.number_of_vertices; ++vertex) {
+            const boost::string_view name = graph_distance.graph.get_vertex_name(vertex);
+            graph_distance.string_to_vertex_descriptor_map[std::string(name.data(), name.size())] = vertex;
+        }
+
+        graph_distance.number_of_connected_components = header.number_of_connected_components;
+        graph_distance.number_of_pairwise_distances = header.number_of_pairwise_distances;
+        graph_distance.vertex_descriptor_to_connected_component_index_map = graph_distance_file->vertex_descriptor_to_connected_component_index_map;
+        graph_distance.size_of_connected_components = graph_distance_file->size_of_connected_components;
+        graph_distance.vertex_descriptor_to_index_map = graph_distance_file->vertex_descriptor_to_index_map;
+        graph_distance.pairwise_index_offsets_of_connected_components = graph_distance_file->pairwise_index_offsets_of_connected_components;
+        graph_distance.pairwise_distances = reinterpret_cast<const Distance*>(graph_distance_file->pairwise_distances);
+        graph_distance.storage = graph_distance_file;
+
+        return graph_distance;
     }
 
     inline size_t vertex_descriptor_index_to_pairwise_index(const size_t first_index, const size_t second_index, const size_t n) const {
@@ -182,66 +576,492 @@ struct GraphDistance {
         return smaller_index * (2 * n - smaller_index - 1) / 2 + larger_index - smaller_index - 1;
     }
 
+    // the distance between two vertices given by their vertex descriptors, which is 0 for the same vertex,
+    // and infinity for vertices in different connected components
+    double get_distance(const VertexDescriptor first_vertex_descriptor, const VertexDescriptor second_vertex_descriptor) const {
+        const size_t first_vertex_connected_component_index = vertex_descriptor_to_connected_component_index_map[first_vertex_descriptor];
+        const size_t second_vertex_connected_component_index = vertex_descriptor_to_connected_component_index_map[second_vertex_descriptor];
+
+        if (first_vertex_connected_component_index != second_vertex_connected_component_index) {
+            return std::numeric_limits<double>::infinity();
+        }
+
+        const size_t first_vertex_index = vertex_descriptor_to_index_map[first_vertex_descriptor];
+        const size_t second_vertex_index = vertex_descriptor_to_index_map[second_vertex_descriptor];
+
+        if (first_vertex_index == second_vertex_index) {
+            return 0;
+        }
+
+        const size_t connected_component_size = size_of_connected_components[first_vertex_connected_component_index];
+        const size_t pairwise_index_offset = pairwise_index_offsets_of_connected_components[first_vertex_connected_component_index];
+
+        const Distance distance = pairwise_distances[pairwise_index_offset + vertex_descriptor_index_to_pairwise_index(first_vertex_index, second_vertex_index, connected_component_size)];
+
+        return (distance != unreachable_distance) ? distance : std::numeric_limits<double>::infinity();
+    }
+
     double operator()(const std::string& first_vertex, const std::string& second_vertex) const {
-        const VertexDescriptor& first_vertex_descriptor = string_to_vertex_descriptor_map.at(first_vertex);
-        const VertexDescriptor& second_vertex_descriptor = string_to_vertex_descriptor_map.at(second_vertex);
+        return get_distance(
+            string_to_vertex_descriptor_map.at(first_vertex),
+            string_to_vertex_descriptor_map.at(second_vertex)
+        );
+    }
+};
 
-        const size_t& first_vertex_index = vertex_descriptor_to_index_map.at(first_vertex_descriptor);
-        const size_t& second_vertex_index = vertex_descriptor_to_index_map.at(second_vertex_descriptor);
+template <typename Distance> const Distance GraphDistance<Distance>::unreachable_distance;
 
-        const size_t& first_vertex_connected_component_index = vertex_descriptor_to_connected_component_index_map.at(first_vertex_descriptor);
-        const size_t& second_vertex_connected_component_index = vertex_descriptor_to_connected_component_index_map.at(first_vertex_descriptor);
 
-        if (first_vertex_connected_component_index == second_vertex_connected_component_index) {
-            if (first_vertex_index != second_vertex_index) {
-                const size_t& connected_component_size = size_of_connected_components.at(first_vertex_connected_component_index);
-                const size_t& pairwise_index_offset = pairwise_index_offsets_of_connected_components.at(first_vertex_connected_component_index);
+// https://doi.org/10.1145/1645953.1646063 (Fast shortest path distance estimation in large networks)
+// Estimates the hop distance of pairs of vertices from their distances to a few landmarks, for graphs whose O(n^2) pairwise distances
+// (as in GraphDistance) do not fit in memory. With d(l, v) the distance from landmark l to v, the triangle inequality bounds
+//     max over l of |d(l, u) - d(l, v)|  <=  d(u, v)  <=  min over l of d(l, u) + d(l, v)
+// where both ends are reached from l, which is exact if a landmark lies on a shortest path between u and v.
+// A query answers the upper bound, or, if is_refined_by_bidirectional_search, the exact distance by a bidirectional breadth-first search
+// that stops once no path shorter than the upper bound remains.
+// Pairs in a connected component without landmarks have no upper bound, so they are always answered by the bidirectional search.
+// The distances to the landmarks take O(number_of_landmarks * n) memory, in a Distance each (see GraphDistance).
+template <typename Distance> struct LandmarkGraphDistance {
+    static const Distance unreachable_distance = std::numeric_limits<Distance>::max();
 
-                return pairwise_distances.at(pairwise_index_offset + vertex_descriptor_index_to_pairwise_index(first_vertex_index, second_vertex_index, connected_component_size));
-            }
-            else {
-                return 0;
+    Graph graph;
+    boost::unordered_map<std::string, VertexDescriptor> string_to_vertex_descriptor_map;
+    std::vector<uint32_t> vertex_descriptor_to_connected_component_index_map;
+    std::vector<VertexDescriptor> landmarks;
+    // the distance from landmarks[l] to vertex v is landmark_distances[v * landmarks.size() + l],
+    // so that the distances of a vertex to all landmarks are contiguous
+    std::vector<Distance> landmark_distances;
+    bool is_refined_by_bidirectional_search;
+
+    // landmark_selection is "degree" for the number_of_landmarks vertices of highest degree (ties broken by the smaller vertex descriptor),
+    // or "random" for number_of_landmarks vertices drawn uniformly with seed
+    LandmarkGraphDistance(
+        const std::string& input_graph_path,
+        const size_t number_of_landmarks,
+        const std::string& landmark_selection,
+        const bool is_refined_by_bidirectional_search,
+        const unsigned int seed
+    ):
+        is_refined_by_bidirectional_search(is_refined_by_bidirectional_search)
+    {
+        // load graph and string_to_vertex_descriptor_map
+        graph = load_csr_graph(
+            string_to_vertex_descriptor_map,
+            input_graph_path
+        );
+
+        const size_t number_of_vertices = boost::num_vertices(graph);
+
+        // initialize vertex_descriptor_to_connected_component_index_map
+        vertex_descriptor_to_connected_component_index_map.resize(number_of_vertices);
+        boost::connected_components(
+            graph,
+            boost::make_iterator_property_map(
+                vertex_descriptor_to_connected_component_index_map.begin(),
+                boost::get(boost::vertex_index, graph)
+            )
+        );
+
+        // select landmarks
+        std::vector<VertexDescriptor> vertices(boost::vertices(graph).first, boost::vertices(graph).second);
+        const size_t number_of_selected_landmarks = std::min(number_of_landmarks, number_of_vertices);
+
+        if (landmark_selection == "degree") {
+            std::partial_sort(
+                vertices.begin(),
+                vertices.begin() + number_of_selected_landmarks,
+                vertices.end(),
+                [this](const VertexDescriptor first_vertex_descriptor, const VertexDescriptor second_vertex_descriptor) {
+                    const size_t first_degree = boost::degree(first_vertex_descriptor, graph);
+                    const size_t second_degree = boost::degree(second_vertex_descriptor, graph);
+                    return (first_degree != second_degree) ? (first_degree > second_degree) : (first_vertex_descriptor < second_vertex_descriptor);
+                }
+            );
+        }
+        else if (landmark_selection == "random") {
+            std::mt19937 random_number_generator(seed);
+            for (size_t landmark_index = 0; landmark_index < number_of_selected_landmarks; ++landmark_index) {
+                std::uniform_int_distribution<size_t> uniform_distribution(landmark_index, number_of_vertices - 1);
+                std::swap(vertices[landmark_index], vertices[uniform_distribution(random_number_generator)]);
             }
         }
         else {
-            return std::numeric_limits<double>::infinity();
+            throw std::invalid_argument("LandmarkGraphDistance: landmark_selection is neither \"degree\" nor \"random\"");
+        }
+
+        landmarks.assign(vertices.begin(), vertices.begin() + number_of_selected_landmarks);
+
+        // breadth-first search from the landmarks, in sweeps of up to NUMBER_OF_SOURCES_PER_SWEEP landmarks,
+        // with sweeps small enough that every thread gets one
+        landmark_distances.assign(number_of_vertices * number_of_selected_landmarks, unreachable_distance);
+        for (size_t landmark_index = 0; landmark_index < number_of_selected_landmarks; ++landmark_index) {
+            landmark_distances[landmarks[landmark_index] * number_of_selected_landmarks + landmark_index] = 0;
+        }
+
+        const unsigned int number_of_threads = std::max(std::thread::hardware_concurrency(), 1u);
+        const size_t number_of_landmarks_per_sweep = std::max<size_t>(
+            std::min<size_t>(NUMBER_OF_SOURCES_PER_SWEEP, (number_of_selected_landmarks + number_of_threads - 1) / number_of_threads),
+            1
+        );
+
+        boost::asio::thread_pool thread_pool(number_of_threads);
+
+        std::atomic<bool> is_distance_overflowed(false);
+
+        for (size_t first_landmark = 0; first_landmark < number_of_selected_landmarks; first_landmark += number_of_landmarks_per_sweep) {
+            const size_t number_of_sweep_landmarks = std::min(number_of_landmarks_per_sweep, number_of_selected_landmarks - first_landmark);
+
+            const auto sweep_task = [
+                this,
+                number_of_vertices,
+                number_of_selected_landmarks,
+                &is_distance_overflowed,
+                first_landmark,
+                number_of_sweep_landmarks
+            ]() {
+                MultiSourceBreadthFirstSearchBuffers buffers;
+
+                const auto write_landmark_distances = [
+                    this,
+                    number_of_selected_landmarks,
+                    &is_distance_overflowed,
+                    first_landmark
+                ](const uint32_t vertex, uint64_t reached_landmarks, const size_t distance) {
+                    if (distance >= unreachable_distance) {
+                        is_distance_overflowed.store(true, std::memory_order_relaxed);
+                        return;
+                    }
+
+                    while (reached_landmarks) {
+                        const size_t landmark_index = first_landmark + __builtin_ctzll(reached_landmarks);
+                        reached_landmarks &= reached_landmarks - 1;
+
+                        landmark_distances[vertex * number_of_selected_landmarks + landmark_index] = static_cast<Distance>(distance);
+                    }
+                };
+
+                multi_source_breadth_first_search(
+                    number_of_vertices,
+                    graph.offsets,
+                    graph.neighbors,
+                    landmarks.data() + first_landmark,
+                    number_of_sweep_landmarks,
+                    buffers,
+                    write_landmark_distances
+                );
+            };
+
+            boost::asio::post(
+                thread_pool,
+                sweep_task
+            );
+        }
+
+        // join thread_pool
+        thread_pool.join();
+
+        if (is_distance_overflowed.load(std::memory_order_relaxed)) {
+            throw std::overflow_error("LandmarkGraphDistance: a distance does not fit in the distance type, use a wider one");
+        }
+    }
+
+    // the lower and upper bounds on the distance between two vertices given by their vertex descriptors,
+    // where the upper bound is infinity if no landmark is in their connected component
+    std::pair<double, double> get_distance_bounds(const VertexDescriptor first_vertex_descriptor, const VertexDescriptor second_vertex_descriptor) const {
+        if (first_vertex_descriptor == second_vertex_descriptor) {
+            return std::make_pair(0.0, 0.0);
+        }
+
+        if (vertex_descriptor_to_connected_component_index_map[first_vertex_descriptor] != vertex_descriptor_to_connected_component_index_map[second_vertex_descriptor]) {
+            return std::make_pair(std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity());
+        }
+
+        const size_t number_of_landmarks = landmarks.size();
+        const Distance* first_vertex_landmark_distances = landmark_distances.data() + first_vertex_descriptor * number_of_landmarks;
+        const Distance* second_vertex_landmark_distances = landmark_distances.data() + second_vertex_descriptor * number_of_landmarks;
+
+        // distinct vertices are at least one hop apart
+        size_t lower_bound = 1;
+        size_t upper_bound = std::numeric_limits<size_t>::max();
+
+        for (size_t landmark_index = 0; landmark_index < number_of_landmarks; ++landmark_index) {
+            const size_t first_distance = first_vertex_landmark_distances[landmark_index];
+            const size_t second_distance = second_vertex_landmark_distances[landmark_index];
+
+            // a landmark reaches either both vertices or neither, as they are in the same connected component
+            if (first_distance != unreachable_distance && second_distance != unreachable_distance) {
+                lower_bound = std::max(lower_bound, (first_distance > second_distance) ? first_distance - second_distance : second_distance - first_distance);
+                upper_bound = std::min(upper_bound, first_distance + second_distance);
+            }
+        }
+
+        return std::make_pair(
+            static_cast<double>(lower_bound),
+            (upper_bound != std::numeric_limits<size_t>::max()) ? static_cast<double>(upper_bound) : std::numeric_limits<double>::infinity()
+        );
+    }
+
+    // the exact distance between two vertices in the same connected component, within [lower_bound, upper_bound],
+    // by breadth-first searches from both vertices, each step expanding the smaller frontier by one level
+    size_t get_distance_by_bidirectional_search(
+        const VertexDescriptor first_vertex_descriptor,
+        const VertexDescriptor second_vertex_descriptor,
+        const size_t lower_bound,
+        const size_t upper_bound
+    ) const {
+        // the vertices reached from each end, with their distances to that end
+        boost::unordered_map<VertexDescriptor, size_t> forward_distances { { first_vertex_descriptor, 0 } };
+        boost::unordered_map<VertexDescriptor, size_t> backward_distances { { second_vertex_descriptor, 0 } };
+        std::vector<VertexDescriptor> forward_frontier { first_vertex_descriptor };
+        std::vector<VertexDescriptor> backward_frontier { second_vertex_descriptor };
+        size_t forward_level = 0;
+        size_t backward_level = 0;
+
+        size_t distance = upper_bound;
+
+        // a path not found yet is longer than both searched levels, so once that reaches distance, no shorter path remains,
+        // and neither does one once distance reaches lower_bound
+        while (
+            !forward_frontier.empty() && !backward_frontier.empty()
+            && forward_level + backward_level + 1 < distance && lower_bound < distance
+        ) {
+            const bool is_forward = forward_frontier.size() <= backward_frontier.size();
+            std::vector<VertexDescriptor>& frontier = is_forward ? forward_frontier : backward_frontier;
+            boost::unordered_map<VertexDescriptor, size_t>& distances = is_forward ? forward_distances : backward_distances;
+            const boost::unordered_map<VertexDescriptor, size_t>& other_distances = is_forward ? backward_distances : forward_distances;
+            const size_t level = is_forward ? ++forward_level : ++backward_level;
+
+            std::vector<VertexDescriptor> next_frontier;
+            for (const VertexDescriptor vertex_descriptor: frontier) {
+                AdjacencyIterator adjacency_iterator, adjacency_end;
+                for (
+                    std::tie(adjacency_iterator, adjacency_end) = boost::adjacent_vertices(vertex_descriptor, graph);
+                    adjacency_iterator != adjacency_end;
+                    ++adjacency_iterator
+                ) {
+                    if (distances.emplace(*adjacency_iterator, level).second) {
+                        const auto other_iterator = other_distances.find(*adjacency_iterator);
+                        if (other_iterator != other_distances.cend()) {
+                            distance = std::min(distance, level + other_iterator->second);
+                        }
+
+                        next_frontier.push_back(*adjacency_iterator);
+                    }
+                }
+            }
+
+            frontier.swap(next_frontier);
         }
+
+        return distance;
+    }
+
+    // the distance between two vertices given by their vertex descriptors, which is 0 for the same vertex,
+    // and infinity for vertices in different connected components
+    // (vertices in the same connected component without landmarks are searched even if not is_refined_by_bidirectional_search,
+    // as their upper bound of infinity would report them as unreachable)
+    double get_distance(const VertexDescriptor first_vertex_descriptor, const VertexDescriptor second_vertex_descriptor) const {
+        const std::pair<double, double> distance_bounds = get_distance_bounds(first_vertex_descriptor, second_vertex_descriptor);
+
+        if (
+            distance_bounds.first == distance_bounds.second || std::isinf(distance_bounds.first)
+            || (!is_refined_by_bidirectional_search && !std::isinf(distance_bounds.second))
+        ) {
+            return distance_bounds.second;
+        }
+
+        const size_t distance = get_distance_by_bidirectional_search(
+            first_vertex_descriptor,
+            second_vertex_descriptor,
+            static_cast<size_t>(distance_bounds.first),
+            std::isinf(distance_bounds.second) ? std::numeric_limits<size_t>::max() : static_cast<size_t>(distance_bounds.second)
+        );
+
+        return static_cast<double>(distance);
+    }
+
+    double operator()(const std::string& first_vertex, const std::string& second_vertex) const {
+        return get_distance(
+            string_to_vertex_descriptor_map.at(first_vertex),
+            string_to_vertex_descriptor_map.at(second_vertex)
+        );
+    }
+
+    std::pair<double, double> bounds(const std::string& first_vertex, const std::string& second_vertex) const {
+        return get_distance_bounds(
+            string_to_vertex_descriptor_map.at(first_vertex),
+            string_to_vertex_descriptor_map.at(second_vertex)
+        );
     }
 };
 
+template <typename Distance> const Distance LandmarkGraphDistance<Distance>::unreachable_distance;
 
-PYBIND11_MODULE(graph_distance, m) {
+
+// Bindings for the queries shared by the graph distance oracles (GraphDistance and LandmarkGraphDistance):
+// __call__ with two vertex names, batch with two numpy arrays of vertex indices or two lists of vertex names, and get_vertex_indices
+template <typename GraphDistanceOracle> void bind_graph_distance_queries(pybind11::class_<GraphDistanceOracle>& class_binding) {
+    class_binding
+        .def("__call__", &GraphDistanceOracle::operator())
+        // the distances of the pairs (first_vertex_indices[i], second_vertex_indices[i]) of two numpy arrays of vertex indices,
+        // as a numpy array of doubles computed without holding the GIL
+        .def(
+            "batch",
+            [](
+                const GraphDistanceOracle& graph_distance_oracle,
+                const pybind11::array_t<int64_t, pybind11::array::c_style | pybind11::array::forcecast>& first_vertex_indices,
+                const pybind11::array_t<int64_t, pybind11::array::c_style | pybind11::array::forcecast>& second_vertex_indices
+            ) {
+                if (first_vertex_indices.size() != second_vertex_indices.size()) {
+                    throw std::invalid_argument("batch: the arrays of vertex indices differ in size");
+                }
+
+                pybind11::array_t<double> distances(first_vertex_indices.size());
+                const int64_t* first_vertex_descriptors = first_vertex_indices.data();
+                const int64_t* second_vertex_descriptors = second_vertex_indices.data();
+                double* distances_data = distances.mutable_data();
+
+                {
+                    pybind11::gil_scoped_release gil_scoped_release;
+                    get_distances_of_pairs(graph_distance_oracle, first_vertex_descriptors, second_vertex_descriptors, distances.size(), distances_data);
+                }
+
+                return distances;
+            }
+        )
+        // the same for two lists of vertex names, which are looked up before the GIL is released
+        .def(
+            "batch",
+            [](
+                const GraphDistanceOracle& graph_distance_oracle,
+                const std::vector<std::string>& first_vertices,
+                const std::vector<std::string>& second_vertices
+            ) {
+                if (first_vertices.size() != second_vertices.size()) {
+                    throw std::invalid_argument("batch: the lists of vertex names differ in size");
+                }
+
+                std::vector<VertexDescriptor> first_vertex_descriptors, second_vertex_descriptors;
+                first_vertex_descriptors.reserve(first_vertices.size());
+                second_vertex_descriptors.reserve(second_vertices.size());
+                for (size_t pair_index = 0; pair_index < first_vertices.size(); ++pair_index) {
+                    first_vertex_descriptors.push_back(graph_distance_oracle.string_to_vertex_descriptor_map.at(first_vertices[pair_index]));
+                    second_vertex_descriptors.push_back(graph_distance_oracle.string_to_vertex_descriptor_map.at(second_vertices[pair_index]));
+                }
+
+                pybind11::array_t<double> distances(first_vertices.size());
+                double* distances_data = distances.mutable_data();
+
+                {
+                    pybind11::gil_scoped_release gil_scoped_release;
+                    get_distances_of_pairs(graph_distance_oracle, first_vertex_descriptors.data(), second_vertex_descriptors.data(), first_vertices.size(), distances_data);
+                }
+
+                return distances;
+            }
+        )
+        // the vertex index of each vertex name, to convert names to the vertex indices of batch() once
+        .def(
+            "get_vertex_indices",
+            [](const GraphDistanceOracle& graph_distance_oracle) {
+                pybind11::dict vertex_indices;
+                for (
+                    auto iterator = graph_distance_oracle.string_to_vertex_descriptor_map.cbegin();
+                    iterator != graph_distance_oracle.string_to_vertex_descriptor_map.cend();
+                    ++iterator
+                ) {
+                    vertex_indices[pybind11::str(iterator->first)] = iterator->second;
+                }
+                return vertex_indices;
+            }
+        );
+}
+
+
+template <typename Distance> void bind_graph_distance(pybind11::module_& m, const char* name) {
     // Bindings for class GraphDistance
-    pybind11::class_<GraphDistance>(
+    pybind11::class_<GraphDistance<Distance>> class_binding(
         m,
-        "GraphDistance",
+        name,
         // Python supports an extremely general and convenient approach for exchanging data between plugin libraries.
         // Types can expose a buffer view, which provides fast direct access to the raw internal data representation.
         pybind11::buffer_protocol()
-    )
+    );
+
+    class_binding
         // bindings for constructor
         // pybind11::init<> internally uses C++11 brace initialization to call the constructor of the target class
         // This means that it can be used to bind implicit constructors as well
         .def(pybind11::init<const std::string&>())
-        // bindings for instance fields
-        // bindings for class methods with template parameters
-        .def("__call__", &GraphDistance::operator())
+        // bindings for saving to and loading from a graph distance file
+        .def("save", &GraphDistance<Distance>::save)
+        .def_static("load", &GraphDistance<Distance>::load)
         // The following binding code exposes the contents as a buffer object, making it possible to cast into NumPy arrays.
         // It is even possible to completely avoid copy operations with Python expressions like np.array(instance, copy=False).
-        .def_buffer([](GraphDistance& graph_distance) -> pybind11::buffer_info {
+        // The buffer is read-only, as the distances of a loaded GraphDistance are in a read-only mapping.
+        .def_buffer([](GraphDistance<Distance>& graph_distance) -> pybind11::buffer_info {
             return pybind11::buffer_info(
                 // Pointer to buffer
-                graph_distance.pairwise_distances.data(),
+                const_cast<Distance*>(graph_distance.pairwise_distances),
                 // Size of one scalar
-                sizeof(double),
+                sizeof(Distance),
                 // Python struct-style format descriptor
-                pybind11::format_descriptor<double>::format(),
+                pybind11::format_descriptor<Distance>::format(),
                 // Number of dimensions
                 1,
                 // Buffer dimensions
-                { graph_distance.pairwise_distances.size() },
+                { graph_distance.number_of_pairwise_distances },
                 // Strides (in bytes) for each index
-                { sizeof(double) }
+                { sizeof(Distance) },
+                // Read-only
+                true
             );
         });
+
+    bind_graph_distance_queries(class_binding);
+}
+
+
+template <typename Distance> void bind_landmark_graph_distance(pybind11::module_& m, const char* name) {
+    // Bindings for class LandmarkGraphDistance
+    pybind11::class_<LandmarkGraphDistance<Distance>> class_binding(
+        m,
+        name
+    );
+
+    class_binding
+        // bindings for constructor
+        .def(
+            pybind11::init<const std::string&, size_t, const std::string&, bool, unsigned int>(),
+            pybind11::arg("input_graph_path"),
+            pybind11::arg("number_of_landmarks") = 16,
+            pybind11::arg("landmark_selection") = "degree",
+            pybind11::arg("is_refined_by_bidirectional_search") = false,
+            pybind11::arg("seed") = 0
+        )
+        // the (lower bound, upper bound) of the distance between two vertex names
+        .def("bounds", &LandmarkGraphDistance<Distance>::bounds)
+        // the vertex names of the landmarks
+        .def(
+            "get_landmarks",
+            [](const LandmarkGraphDistance<Distance>& landmark_graph_distance) {
+                std::vector<std::string> landmarks;
+                for (const VertexDescriptor landmark: landmark_graph_distance.landmarks) {
+                    const boost::string_view name = landmark_graph_distance.graph.get_vertex_name(landmark);
+                    landmarks.push_back(std::string(name.data(), name.size()));
+                }
+                return landmarks;
+            }
+        );
+
+    bind_graph_distance_queries(class_binding);
+}
+
+
+PYBIND11_MODULE(graph_distance, m) {
+    // hop counts on social networks fit in a byte, GraphDistance16 is for graphs with a diameter of 255 or more
+    bind_graph_distance<uint8_t>(m, "GraphDistance");
+    bind_graph_distance<uint16_t>(m, "GraphDistance16");
+    bind_landmark_graph_distance<uint8_t>(m, "LandmarkGraphDistance");
+    bind_landmark_graph_distance<uint16_t>(m, "LandmarkGraphDistance16");
 }
@@ -6,13 +6,16 @@ TAU=3600
 DELTA=1000
 
 SOCIAL_NETWORKS_DIRECTORY="$EXPERIMENT_ROOT/social_networks"
+BINARY_SOCIAL_NETWORKS_DIRECTORY="$EXPERIMENT_ROOT/binary_social_networks"
 TRAJECTORIES_DIRECTORY="$EXPERIMENT_ROOT/trajectories"
+BINARY_TRAJECTORIES_DIRECTORY="$EXPERIMENT_ROOT/binary_trajectories"
 
 MATCHING_POINT_SPATIAL_TEMPORAL_DISTANCES_DIRECTORY="$EXPERIMENT_ROOT/matching_point_spatial_temporal_distances"
 SPATIOTEMPORAL_LCSS_MATCHING_POINT_SPATIAL_TEMPORAL_DISTANCES_DIRECTORY="$EXPERIMENT_ROOT/spatiotemporal_lcss_matching_point_spatial_temporal_distances"
 STLC_MATCHING_POINT_SPATIAL_TEMPORAL_DISTANCES_DIRECTORY="$EXPERIMENT_ROOT/stlc_matching_point_spatial_temporal_distances"
 
 TRAJECTORY_SIMILARITY_RUNTIMES_DIRECTORY="$EXPERIMENT_ROOT/trajectory_similarity_runtimes"
+CORE_NUMBER_RUNTIMES_DIRECTORY="$EXPERIMENT_ROOT/core_number_runtimes"
 
 DETECTED_COMMUNITIES_DIRECTORY="$EXPERIMENT_ROOT/detected_communities"
 COMMUNITY_DETECTION_TIMES_DIRECTORY="$EXPERIMENT_ROOT/community_detection_times"
@@ -28,6 +31,7 @@ SPATIOTEMPORAL_LCSS_MATCHING_POINT_SPATIAL_TEMPORAL_DISTANCE_PATH="$EXPERIMENTAL
 STLC_MATCHING_POINT_SPATIAL_TEMPORAL_DISTANCE_PATH="$EXPERIMENTAL_CODE_DIRECTORY/stlc_matching_point_spatial_temporal_distance"
 
 PROFILE_TRAJECTORY_SIMILARITY_RUNTIMES_PATH="$EXPERIMENTAL_CODE_DIRECTORY/profile_trajectory_similarity_runtimes"
+PROFILE_CORE_NUMBER_RUNTIMES_PATH="$EXPERIMENTAL_CODE_DIRECTORY/profile_core_number_runtimes"
 
 COMMUNITY_DETECTION_PATH="$EXPERIMENTAL_CODE_DIRECTORY/community_detection"
 
@@ -35,3 +39,7 @@ CALCULATE_K_CORE_PATH="$EXPERIMENTAL_CODE_DIRECTORY/calculate_k_core"
 
 CALCULATE_PAIRWISE_SIMILARITIES_PATH="$EXPERIMENTAL_CODE_DIRECTORY/calculate_pairwise_similarities"
 
+CONVERT_TRAJECTORIES_PATH="$EXPERIMENTAL_CODE_DIRECTORY/convert_trajectories"
+
+CONVERT_GRAPH_PATH="$EXPERIMENTAL_CODE_DIRECTORY/convert_graph"
+
@@ -18,6 +18,31 @@ make
 popd
 
 
+# Convert the social networks into CSR graph files and the trajectories into binary trajectory files, which load far faster than text files.
+
+
+mkdir -p "$BINARY_SOCIAL_NETWORKS_DIRECTORY"
+
+for social_network_path in "$SOCIAL_NETWORKS_DIRECTORY"/*
+do
+    social_network="$(basename "$social_network_path")"
+    
+    echo "$CONVERT_GRAPH_PATH" -g "$social_network_path" -o "$BINARY_SOCIAL_NETWORKS_DIRECTORY/$social_network"
+    "$CONVERT_GRAPH_PATH" -g "$social_network_path" -o "$BINARY_SOCIAL_NETWORKS_DIRECTORY/$social_network"
+done
+
+
+mkdir -p "$BINARY_TRAJECTORIES_DIRECTORY"
+
+for social_network_path in "$SOCIAL_NETWORKS_DIRECTORY"/*
+do
+    social_network="$(basename "$social_network_path")"
+    
+    echo "$CONVERT_TRAJECTORIES_PATH" -t "$TRAJECTORIES_DIRECTORY/$social_network" -o "$BINARY_TRAJECTORIES_DIRECTORY/$social_network"
+    "$CONVERT_TRAJECTORIES_PATH" -t "$TRAJECTORIES_DIRECTORY/$social_network" -o "$BINARY_TRAJECTORIES_DIRECTORY/$social_network"
+done
+
+
 # Calculate the Spatiotemporal Distances of Matching Points within our trajectory similarity algorithm, OverallSimilarity.
 
 
@@ -27,10 +52,11 @@ for social_network_path in "$SOCIAL_NETWORKS_DIRECTORY"/*
 do
     social_network="$(basename "$social_network_path")"
     
-    trajectory_path="$TRAJECTORIES_DIRECTORY/$social_network"
+    graph_path="$BINARY_SOCIAL_NETWORKS_DIRECTORY/$social_network"
+    trajectory_path="$BINARY_TRAJECTORIES_DIRECTORY/$social_network"
     
-    echo "$MATCHING_POINT_SPATIAL_TEMPORAL_DISTANCE_PATH" -g "$social_network_path" -t "$trajectory_path" --delta "$DELTA" --tau "$TAU" -o "$MATCHING_POINT_SPATIAL_TEMPORAL_DISTANCES_DIRECTORY/$social_network"
-    "$MATCHING_POINT_SPATIAL_TEMPORAL_DISTANCE_PATH" -g "$social_network_path" -t "$trajectory_path" --delta "$DELTA" --tau "$TAU" -o "$MATCHING_POINT_SPATIAL_TEMPORAL_DISTANCES_DIRECTORY/$social_network"
+    echo "$MATCHING_POINT_SPATIAL_TEMPORAL_DISTANCE_PATH" -g "$graph_path" -t "$trajectory_path" --delta "$DELTA" --tau "$TAU" -o "$MATCHING_POINT_SPATIAL_TEMPORAL_DISTANCES_DIRECTORY/$social_network"
+    "$MATCHING_POINT_SPATIAL_TEMPORAL_DISTANCE_PATH" -g "$graph_path" -t "$trajectory_path" --delta "$DELTA" --tau "$TAU" -o "$MATCHING_POINT_SPATIAL_TEMPORAL_DISTANCES_DIRECTORY/$social_network"
 done
 
 
@@ -43,14 +69,15 @@ for social_network_path in "$SOCIAL_NETWORKS_DIRECTORY"/*
 do
     social_network="$(basename "$social_network_path")"
     
-    trajectory_path="$TRAJECTORIES_DIRECTORY/$social_network"
+    graph_path="$BINARY_SOCIAL_NETWORKS_DIRECTORY/$social_network"
+    trajectory_path="$BINARY_TRAJECTORIES_DIRECTORY/$social_network"
     
     mkdir -p "$SPATIOTEMPORAL_LCSS_MATCHING_POINT_SPATIAL_TEMPORAL_DISTANCES_DIRECTORY/$social_network"
     
     for factor in $(seq 1 1 5)
     do
-        echo "$SPATIOTEMPORAL_LCSS_MATCHING_POINT_SPATIAL_TEMPORAL_DISTANCE_PATH" -g "$social_network_path" -t "$trajectory_path" --epsilon "$(expr "$DELTA" '*' "$factor")" --delta "$(expr "$TAU" '*' "$factor")" -o "$SPATIOTEMPORAL_LCSS_MATCHING_POINT_SPATIAL_TEMPORAL_DISTANCES_DIRECTORY/$social_network/$factor"
-        "$SPATIOTEMPORAL_LCSS_MATCHING_POINT_SPATIAL_TEMPORAL_DISTANCE_PATH" -g "$social_network_path" -t "$trajectory_path" --epsilon "$(expr "$DELTA" '*' "$factor")" --delta "$(expr "$TAU" '*' "$factor")" -o "$SPATIOTEMPORAL_LCSS_MATCHING_POINT_SPATIAL_TEMPORAL_DISTANCES_DIRECTORY/$social_network/$factor"
+        echo "$SPATIOTEMPORAL_LCSS_MATCHING_POINT_SPATIAL_TEMPORAL_DISTANCE_PATH" -g "$graph_path" -t "$trajectory_path" --epsilon "$(expr "$DELTA" '*' "$factor")" --delta "$(expr "$TAU" '*' "$factor")" -o "$SPATIOTEMPORAL_LCSS_MATCHING_POINT_SPATIAL_TEMPORAL_DISTANCES_DIRECTORY/$social_network/$factor"
+        "$SPATIOTEMPORAL_LCSS_MATCHING_POINT_SPATIAL_TEMPORAL_DISTANCE_PATH" -g "$graph_path" -t "$trajectory_path" --epsilon "$(expr "$DELTA" '*' "$factor")" --delta "$(expr "$TAU" '*' "$factor")" -o "$SPATIOTEMPORAL_LCSS_MATCHING_POINT_SPATIAL_TEMPORAL_DISTANCES_DIRECTORY/$social_network/$factor"
     done
 done
 
@@ -60,19 +87,20 @@ done
 
 mkdir -p "$STLC_MATCHING_POINT_SPATIAL_TEMPORAL_DISTANCES_DIRECTORY"
 
+lambda_values="$(seq -s ',' 0.1 0.1 0.9)"
+
 for social_network_path in "$SOCIAL_NETWORKS_DIRECTORY"/*
 do
     social_network="$(basename "$social_network_path")"
     
-    trajectory_path="$TRAJECTORIES_DIRECTORY/$social_network"
+    graph_path="$BINARY_SOCIAL_NETWORKS_DIRECTORY/$social_network"
+    trajectory_path="$BINARY_TRAJECTORIES_DIRECTORY/$social_network"
     
     mkdir -p "$STLC_MATCHING_POINT_SPATIAL_TEMPORAL_DISTANCES_DIRECTORY/$social_network"
     
-    for lambda in $(seq 0.1 0.1 0.9)
-    do
-        echo "$STLC_MATCHING_POINT_SPATIAL_TEMPORAL_DISTANCE_PATH" -g "$social_network_path" -t "$trajectory_path" --lambda "$lambda" -o "$STLC_MATCHING_POINT_SPATIAL_TEMPORAL_DISTANCES_DIRECTORY/$social_network/$lambda"
-        "$STLC_MATCHING_POINT_SPATIAL_TEMPORAL_DISTANCE_PATH" -g "$social_network_path" -t "$trajectory_path" --lambda "$lambda" -o "$STLC_MATCHING_POINT_SPATIAL_TEMPORAL_DISTANCES_DIRECTORY/$social_network/$lambda"
-    done
+    # All values of lambda are evaluated in a single run, which calculates the spatial and temporal similarities only once.
+    echo "$STLC_MATCHING_POINT_SPATIAL_TEMPORAL_DISTANCE_PATH" -g "$graph_path" -t "$trajectory_path" --lambda-values "$lambda_values" -o "$STLC_MATCHING_POINT_SPATIAL_TEMPORAL_DISTANCES_DIRECTORY/$social_network"
+    "$STLC_MATCHING_POINT_SPATIAL_TEMPORAL_DISTANCE_PATH" -g "$graph_path" -t "$trajectory_path" --lambda-values "$lambda_values" -o "$STLC_MATCHING_POINT_SPATIAL_TEMPORAL_DISTANCES_DIRECTORY/$social_network"
 done
 
 
@@ -85,31 +113,73 @@ for social_network_path in "$SOCIAL_NETWORKS_DIRECTORY"/*
 do
     social_network="$(basename "$social_network_path")"
     
-    trajectory_path="$TRAJECTORIES_DIRECTORY/$social_network"
+    graph_path="$BINARY_SOCIAL_NETWORKS_DIRECTORY/$social_network"
+    trajectory_path="$BINARY_TRAJECTORIES_DIRECTORY/$social_network"
     
-    echo "$PROFILE_TRAJECTORY_SIMILARITY_RUNTIMES_PATH" -g "$social_network_path" -t "$trajectory_path" -o "$TRAJECTORY_SIMILARITY_RUNTIMES_DIRECTORY/$social_network"
-    "$PROFILE_TRAJECTORY_SIMILARITY_RUNTIMES_PATH" -g "$social_network_path" -t "$trajectory_path" -o "$TRAJECTORY_SIMILARITY_RUNTIMES_DIRECTORY/$social_network"
+    echo "$PROFILE_TRAJECTORY_SIMILARITY_RUNTIMES_PATH" -g "$graph_path" -t "$trajectory_path" -o "$TRAJECTORY_SIMILARITY_RUNTIMES_DIRECTORY/$social_network"
+    "$PROFILE_TRAJECTORY_SIMILARITY_RUNTIMES_PATH" -g "$graph_path" -t "$trajectory_path" -o "$TRAJECTORY_SIMILARITY_RUNTIMES_DIRECTORY/$social_network"
+done
+
+
+# Profile the runtimes of core decomposition on a boost::adjacency_list and a CSRGraph, and with flat arrays of 64-bit and 32-bit indices.
+
+
+mkdir -p "$CORE_NUMBER_RUNTIMES_DIRECTORY"
+
+for social_network_path in "$SOCIAL_NETWORKS_DIRECTORY"/*
+do
+    social_network="$(basename "$social_network_path")"
+    
+    graph_path="$BINARY_SOCIAL_NETWORKS_DIRECTORY/$social_network"
+    
+    echo "$PROFILE_CORE_NUMBER_RUNTIMES_PATH" -g "$graph_path" -o "$CORE_NUMBER_RUNTIMES_DIRECTORY/$social_network" --threads "$(nproc)"
+    "$PROFILE_CORE_NUMBER_RUNTIMES_PATH" -g "$graph_path" -o "$CORE_NUMBER_RUNTIMES_DIRECTORY/$social_network" --threads "$(nproc)"
 done
 
 
 # Run community detection using our trajectory similarity algorithm, OverallSimilarity, and our community detection algorithm.
+# All values of k and m are swept over in a single run, which calculates the trajectory similarities only once, and the core numbers only once for each m.
+
 
+k_values="$(echo $K_VALUES | tr ' ' ',')"
+m_values="$(echo $M_VALUES | tr ' ' ',')"
 
 for social_network_path in "$SOCIAL_NETWORKS_DIRECTORY"/*
 do
     social_network="$(basename "$social_network_path")"
     
-    trajectory_path="$TRAJECTORIES_DIRECTORY/$social_network"
+    graph_path="$BINARY_SOCIAL_NETWORKS_DIRECTORY/$social_network"
+    trajectory_path="$BINARY_TRAJECTORIES_DIRECTORY/$social_network"
     
     for k in $K_VALUES
     do
         mkdir -p "$DETECTED_COMMUNITIES_DIRECTORY/$social_network/$k"
+    done
+    
+    echo "$COMMUNITY_DETECTION_PATH" --k-values "$k_values" --m-values "$m_values" -g "$graph_path" -t "$trajectory_path" -o "$DETECTED_COMMUNITIES_DIRECTORY/$social_network"
+    "$COMMUNITY_DETECTION_PATH" --k-values "$k_values" --m-values "$m_values" -g "$graph_path" -t "$trajectory_path" -o "$DETECTED_COMMUNITIES_DIRECTORY/$social_network"
+done
+
+
+# Profile the end-to-end runtimes of community detection for each k and m, as plotted in community_detection_times.ipynb.
+# Each value of m is run on its own, since the runtimes of a sweep share the trajectory similarities and core numbers across values of m.
+
+
+for social_network_path in "$SOCIAL_NETWORKS_DIRECTORY"/*
+do
+    social_network="$(basename "$social_network_path")"
+    
+    graph_path="$BINARY_SOCIAL_NETWORKS_DIRECTORY/$social_network"
+    trajectory_path="$BINARY_TRAJECTORIES_DIRECTORY/$social_network"
+    
+    for k in $K_VALUES
+    do
         mkdir -p "$COMMUNITY_DETECTION_TIMES_DIRECTORY/$social_network/$k"
         
         for m in $M_VALUES
         do
-            echo "$COMMUNITY_DETECTION_PATH" -k "$k" -m "$m" -g "$social_network_path" -t "$trajectory_path" -o "$DETECTED_COMMUNITIES_DIRECTORY/$social_network/$k/$m"
-            "$COMMUNITY_DETECTION_PATH" -k "$k" -m "$m" -g "$social_network_path" -t "$trajectory_path" -o "$DETECTED_COMMUNITIES_DIRECTORY/$social_network/$k/$m" > "$COMMUNITY_DETECTION_TIMES_DIRECTORY/$social_network/$k/$m"
+            echo "$COMMUNITY_DETECTION_PATH" -k "$k" -m "$m" -g "$graph_path" -t "$trajectory_path" -o "$DETECTED_COMMUNITIES_DIRECTORY/$social_network/$k/$m"
+            "$COMMUNITY_DETECTION_PATH" -k "$k" -m "$m" -g "$graph_path" -t "$trajectory_path" -o "$DETECTED_COMMUNITIES_DIRECTORY/$social_network/$k/$m" > "$COMMUNITY_DETECTION_TIMES_DIRECTORY/$social_network/$k/$m"
         done
     done
 done
@@ -122,13 +192,12 @@ for social_network_path in "$SOCIAL_NETWORKS_DIRECTORY"/*
 do
     social_network="$(basename "$social_network_path")"
     
+    graph_path="$BINARY_SOCIAL_NETWORKS_DIRECTORY/$social_network"
+    
     mkdir -p "$K_CORES_DIRECTORY/$social_network"
     
-    for k in $K_VALUES
-    do
-        echo "$CALCULATE_K_CORE_PATH" -k "$k" -g "$social_network_path" -o "$K_CORES_DIRECTORY/$social_network/$k"
-        "$CALCULATE_K_CORE_PATH" -k "$k" -g "$social_network_path" -o "$K_CORES_DIRECTORY/$social_network/$k"
-    done
+    echo "$CALCULATE_K_CORE_PATH" --k-values "$k_values" -g "$graph_path" -o "$K_CORES_DIRECTORY/$social_network"
+    "$CALCULATE_K_CORE_PATH" --k-values "$k_values" -g "$graph_path" -o "$K_CORES_DIRECTORY/$social_network"
 done
 
 
@@ -143,7 +212,7 @@ for social_network_path in "$SOCIAL_NETWORKS_DIRECTORY"/*
 do
     social_network="$(basename "$social_network_path")"
     
-    trajectory_path="$TRAJECTORIES_DIRECTORY/$social_network"
+    trajectory_path="$BINARY_TRAJECTORIES_DIRECTORY/$social_network"
     
     echo "$CALCULATE_PAIRWISE_SIMILARITIES_PATH" -g "$K_CORES_DIRECTORY/$social_network/$min_k" -t "$trajectory_path" -o "$PAIRWISE_SIMILARITIES_DIRECTORY/$social_network"
     "$CALCULATE_PAIRWISE_SIMILARITIES_PATH" -g "$K_CORES_DIRECTORY/$social_network/$min_k" -t "$trajectory_path" -o "$PAIRWISE_SIMILARITIES_DIRECTORY/$social_network"